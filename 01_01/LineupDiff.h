@@ -0,0 +1,115 @@
+// LineupDiff.h
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "StationTable.h"
+
+// ==== 2つの並びの差分 ====
+struct LineupChange {
+  enum class Kind { Insert, Remove, Move };
+
+  Kind kind;
+  StationId station;
+  // Insert / Move: 新しい並びでの直前の駅、Remove: 古い並びでの直前の駅
+  // （先頭なら kNoStation）
+  StationId after;
+};
+
+struct LineupDiff {
+  std::vector<LineupChange> changes; // Remove（旧順）→ Insert/Move（新順）
+  size_t kept = 0;                   // 位置関係が変わらなかった駅の数
+
+  size_t Count(LineupChange::Kind kind) const {
+    return static_cast<size_t>(std::count_if(
+        changes.begin(), changes.end(),
+        [kind](const LineupChange &c) { return c.kind == kind; }));
+  }
+  bool empty() const { return changes.empty(); }
+};
+
+// ==== 差分計算 ====
+//  1路線に同じ駅は1つだけなので、LCS は「共通の駅を新しい順に並べたときの
+//  旧位置の最長増加部分列（LIS）」に帰着する（Hunt-Szymanski）。
+//  ID を添字にした配列で位置を引くので全体で O((n + m) log n)。
+//   - 旧にだけある駅 → Remove
+//   - 新にだけある駅 → Insert
+//   - 両方にあるが LIS に入らない駅 → Move
+inline LineupDiff DiffLineups(const std::vector<StationId> &before,
+                              const std::vector<StationId> &after) {
+  const std::uint32_t kNone = static_cast<std::uint32_t>(-1);
+
+  StationId maxId = 0;
+  for (StationId s : before)
+    maxId = std::max(maxId, s);
+  for (StationId s : after)
+    maxId = std::max(maxId, s);
+  const size_t idRange = before.empty() && after.empty() ? 0 : maxId + 1u;
+
+  // 駅ID → 旧位置 / 新にあるか
+  std::vector<std::uint32_t> posBefore(idRange, kNone);
+  for (size_t i = 0; i < before.size(); ++i)
+    posBefore[before[i]] = static_cast<std::uint32_t>(i);
+  std::vector<char> inAfter(idRange, 0);
+  for (StationId s : after)
+    inAfter[s] = 1;
+
+  // 共通の駅の旧位置を新しい順に並べる
+  std::vector<std::uint32_t> seq;  // 旧位置
+  std::vector<std::uint32_t> seqJ; // 新位置
+  seq.reserve(after.size());
+  seqJ.reserve(after.size());
+  for (size_t j = 0; j < after.size(); ++j) {
+    const std::uint32_t i = posBefore[after[j]];
+    if (i != kNone) {
+      seq.push_back(i);
+      seqJ.push_back(static_cast<std::uint32_t>(j));
+    }
+  }
+
+  // LIS（patience sorting）。tails[k] = 長さ k+1 の末尾要素の添字
+  std::vector<std::uint32_t> tails;
+  std::vector<std::uint32_t> prev(seq.size(), kNone);
+  for (size_t k = 0; k < seq.size(); ++k) {
+    const auto it = std::lower_bound(
+        tails.begin(), tails.end(), seq[k],
+        [&seq](std::uint32_t t, std::uint32_t v) { return seq[t] < v; });
+    if (it != tails.begin())
+      prev[k] = *(it - 1);
+    if (it == tails.end())
+      tails.push_back(static_cast<std::uint32_t>(k));
+    else
+      *it = static_cast<std::uint32_t>(k);
+  }
+  std::vector<char> keepAt(after.size(), 0); // 新位置で LIS に入ったか
+  for (std::uint32_t k = tails.empty() ? kNone : tails.back(); k != kNone;
+       k = prev[k])
+    keepAt[seqJ[k]] = 1;
+
+  LineupDiff diff;
+  diff.kept = tails.size();
+  for (size_t i = 0; i < before.size(); ++i) {
+    if (!inAfter[before[i]]) {
+      diff.changes.push_back({LineupChange::Kind::Remove, before[i],
+                              i ? before[i - 1] : kNoStation});
+    }
+  }
+  for (size_t j = 0; j < after.size(); ++j) {
+    if (keepAt[j])
+      continue;
+    const auto kind = posBefore[after[j]] == kNone ? LineupChange::Kind::Insert
+                                                   : LineupChange::Kind::Move;
+    diff.changes.push_back({kind, after[j], j ? after[j - 1] : kNoStation});
+  }
+  return diff;
+}
+
+// 任意の並び（std::list / PersistentList など）から
+template <class RouteA, class RouteB>
+LineupDiff DiffLineups(const RouteA &before, const RouteB &after) {
+  return DiffLineups(std::vector<StationId>(before.begin(), before.end()),
+                     std::vector<StationId>(after.begin(), after.end()));
+}
@@ -0,0 +1,67 @@
+// OutputBuffer.h
+#pragma once
+
+#include <charconv> // to_chars
+#include <cstddef>
+#include <cstring> // memcpy, strlen, memset
+#include <ostream>
+#include <vector>
+
+// ==== 書式付き出力のまとめ書きバッファ ====
+//  - 表全体を1つの連続したバッファに組み立て、Flush で1回だけ書き出す
+//  - 数値は std::to_chars で直接書く（ロケールや iostream の書式状態を経由しない）
+//  - 左寄せの桁揃えは std::left << std::setw(w) と同じ結果になる
+//    （w より長い値は切り詰めない）
+class OutputBuffer {
+public:
+  void reserve(size_t n) { m_buf.reserve(n); }
+  void clear() { m_buf.clear(); }
+  const char *data() const { return m_buf.data(); }
+  size_t size() const { return m_buf.size(); }
+
+  void Append(const char *s, size_t n) {
+    const size_t at = Grow(n);
+    std::memcpy(m_buf.data() + at, s, n);
+  }
+  void Append(const char *s) { Append(s, std::strlen(s)); }
+  void Append(char c) { m_buf.push_back(c); }
+
+  template <class Int> void AppendInt(Int v) {
+    char tmp[24];
+    const auto r = std::to_chars(tmp, tmp + sizeof(tmp), v);
+    Append(tmp, static_cast<size_t>(r.ptr - tmp));
+  }
+
+  // 左寄せで width 桁に揃える
+  void AppendLeft(const char *s, size_t n, size_t width) {
+    Append(s, n);
+    Pad(n, width);
+  }
+  template <class Int> void AppendIntLeft(Int v, size_t width) {
+    char tmp[24];
+    const auto r = std::to_chars(tmp, tmp + sizeof(tmp), v);
+    AppendLeft(tmp, static_cast<size_t>(r.ptr - tmp), width);
+  }
+
+  // まとめて1回で書き出し、バッファを空にする
+  void Flush(std::ostream &os) {
+    os.write(m_buf.data(), static_cast<std::streamsize>(m_buf.size()));
+    m_buf.clear();
+  }
+
+private:
+  size_t Grow(size_t n) {
+    const size_t at = m_buf.size();
+    m_buf.resize(at + n);
+    return at;
+  }
+
+  void Pad(size_t n, size_t width) {
+    if (n >= width)
+      return;
+    const size_t at = Grow(width - n);
+    std::memset(m_buf.data() + at, ' ', width - n);
+  }
+
+  std::vector<char> m_buf;
+};
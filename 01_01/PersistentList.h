@@ -0,0 +1,221 @@
+// PersistentList.h
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// ==== 永続（イミュータブル）列 ====
+//  - 位置をキーにした AVL 木。各ノードは部分木のサイズを持つ
+//  - Insert / Erase は元の列を変えず、新しい列を返す
+//    （経路上の O(log n) ノードだけ複製し、残りは元の列と共有する）
+//  - At(i) / Set(i, v) は O(log n)
+template <class T> class PersistentList {
+  struct Node;
+  using NodePtr = std::shared_ptr<const Node>;
+
+  struct Node {
+    T value;
+    NodePtr left, right;
+    size_t size;
+    int height;
+  };
+
+public:
+  // ---- 中間順の前進イテレータ ----
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T *;
+    using reference = const T &;
+
+    const_iterator() = default;
+
+    reference operator*() const { return m_stack.back()->value; }
+    pointer operator->() const { return &m_stack.back()->value; }
+
+    const_iterator &operator++() {
+      const Node *n = m_stack.back();
+      m_stack.pop_back();
+      PushLeft(n->right.get());
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const const_iterator &o) const {
+      if (m_stack.empty() || o.m_stack.empty())
+        return m_stack.empty() == o.m_stack.empty();
+      return m_stack.back() == o.m_stack.back();
+    }
+    bool operator!=(const const_iterator &o) const { return !(*this == o); }
+
+  private:
+    friend class PersistentList;
+    explicit const_iterator(const Node *root) { PushLeft(root); }
+
+    void PushLeft(const Node *n) {
+      for (; n; n = n->left.get())
+        m_stack.push_back(n);
+    }
+
+    std::vector<const Node *> m_stack;
+  };
+
+  PersistentList() = default;
+
+  // 範囲から平衡木を一括構築 O(n)
+  template <class It> PersistentList(It first, It last) {
+    std::vector<T> v(first, last);
+    m_root = Build(v.data(), v.size());
+  }
+
+  size_t size() const { return Size(m_root); }
+  bool empty() const { return !m_root; }
+
+  // i 番目の要素（0始まり）
+  const T &At(size_t i) const {
+    const Node *n = m_root.get();
+    for (;;) {
+      const size_t ls = Size(n->left);
+      if (i < ls) {
+        n = n->left.get();
+      } else if (i > ls) {
+        i -= ls + 1;
+        n = n->right.get();
+      } else {
+        return n->value;
+      }
+    }
+  }
+  const T &operator[](size_t i) const { return At(i); }
+
+  // i 番目の前に v を入れた新しい列（i == size() で末尾）
+  PersistentList Insert(size_t i, const T &v) const {
+    return PersistentList(InsertAt(m_root, i, v));
+  }
+
+  // i 番目を取り除いた新しい列
+  PersistentList Erase(size_t i) const {
+    return PersistentList(EraseAt(m_root, i));
+  }
+
+  // i 番目を v に置き換えた新しい列
+  PersistentList Set(size_t i, const T &v) const {
+    return PersistentList(SetAt(m_root, i, v));
+  }
+
+  // 昇順に並んだ列で v 以上の最初の位置。無ければ size()  … O(log n)
+  size_t LowerBound(const T &v) const {
+    size_t base = 0, found = size();
+    for (const Node *n = m_root.get(); n;) {
+      const size_t ls = Size(n->left);
+      if (n->value < v) {
+        base += ls + 1;
+        n = n->right.get();
+      } else {
+        found = base + ls;
+        n = n->left.get();
+      }
+    }
+    return found;
+  }
+
+  // pred を満たす最初の位置。無ければ size()  … O(n)
+  template <class Pred> size_t FindIf(Pred pred) const {
+    size_t i = 0;
+    for (const_iterator it = begin(); it != end(); ++it, ++i) {
+      if (pred(*it))
+        return i;
+    }
+    return i;
+  }
+
+  const_iterator begin() const { return const_iterator(m_root.get()); }
+  const_iterator end() const { return const_iterator(); }
+
+private:
+  explicit PersistentList(NodePtr root) : m_root(std::move(root)) {}
+
+  static size_t Size(const NodePtr &n) { return n ? n->size : 0; }
+  static int Height(const NodePtr &n) { return n ? n->height : 0; }
+
+  static NodePtr Make(const T &v, NodePtr l, NodePtr r) {
+    const size_t size = Size(l) + Size(r) + 1;
+    const int hl = Height(l), hr = Height(r);
+    const int height = (hl > hr ? hl : hr) + 1;
+    return std::make_shared<const Node>(
+        Node{v, std::move(l), std::move(r), size, height});
+  }
+
+  // 左右の高さの差が高々2の部分木を回転して平衡させる
+  static NodePtr Balance(const T &v, NodePtr l, NodePtr r) {
+    const int hl = Height(l), hr = Height(r);
+    if (hl > hr + 1) {
+      if (Height(l->left) >= Height(l->right))
+        return Make(l->value, l->left, Make(v, l->right, std::move(r)));
+      const Node &lr = *l->right;
+      return Make(lr.value, Make(l->value, l->left, lr.left),
+                  Make(v, lr.right, std::move(r)));
+    }
+    if (hr > hl + 1) {
+      if (Height(r->right) >= Height(r->left))
+        return Make(r->value, Make(v, std::move(l), r->left), r->right);
+      const Node &rl = *r->left;
+      return Make(rl.value, Make(v, std::move(l), rl.left),
+                  Make(r->value, rl.right, r->right));
+    }
+    return Make(v, std::move(l), std::move(r));
+  }
+
+  static NodePtr InsertAt(const NodePtr &n, size_t i, const T &v) {
+    if (!n)
+      return Make(v, nullptr, nullptr);
+    const size_t ls = Size(n->left);
+    if (i <= ls)
+      return Balance(n->value, InsertAt(n->left, i, v), n->right);
+    return Balance(n->value, n->left, InsertAt(n->right, i - ls - 1, v));
+  }
+
+  static NodePtr EraseAt(const NodePtr &n, size_t i) {
+    const size_t ls = Size(n->left);
+    if (i < ls)
+      return Balance(n->value, EraseAt(n->left, i), n->right);
+    if (i > ls)
+      return Balance(n->value, n->left, EraseAt(n->right, i - ls - 1));
+    if (!n->left)
+      return n->right;
+    if (!n->right)
+      return n->left;
+    // 右部分木の先頭を繰り上げる
+    const Node *succ = n->right.get();
+    while (succ->left)
+      succ = succ->left.get();
+    return Balance(succ->value, n->left, EraseAt(n->right, 0));
+  }
+
+  static NodePtr SetAt(const NodePtr &n, size_t i, const T &v) {
+    const size_t ls = Size(n->left);
+    if (i < ls)
+      return Make(n->value, SetAt(n->left, i, v), n->right);
+    if (i > ls)
+      return Make(n->value, n->left, SetAt(n->right, i - ls - 1, v));
+    return Make(v, n->left, n->right);
+  }
+
+  static NodePtr Build(const T *v, size_t count) {
+    if (count == 0)
+      return nullptr;
+    const size_t mid = count / 2;
+    return Make(v[mid], Build(v, mid), Build(v + mid + 1, count - mid - 1));
+  }
+
+  NodePtr m_root;
+};
@@ -0,0 +1,193 @@
+// RouteTimeline.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "PersistentList.h"
+#include "StationTable.h"
+
+// ==== 1件の路線変更 ====
+struct RouteEdit {
+  enum class Kind { Insert, Remove };
+
+  Kind kind;
+  StationId station; // 対象の駅
+  StationId after;   // Insert のみ：この駅の直後に入れる（無ければ末尾）
+
+  static RouteEdit InsertAfter(StationId after, StationId station) {
+    return RouteEdit{Kind::Insert, station, after};
+  }
+  static RouteEdit Remove(StationId station) {
+    return RouteEdit{Kind::Remove, station, kNoStation};
+  }
+};
+
+// ==== 版の履歴（タイムライン） ====
+//  - 各版は親の版への差分として記録する
+//  - 路線は PersistentList なので親と構造を共有し、
+//    メモリは「版の数 × 駅数」ではなく「変更数 × log(駅数)」に比例する
+//  - 駅の位置は走査せずに引く。各版は路線と同じ順に増える「順序ラベル」の列と、
+//    駅 ID → ラベルの表を（どちらも PersistentList で）持ち、
+//    ラベルの二分探索で位置を求める。1件の変更は O(log n)（ラベルの隙間が
+//    尽きたときの振り直しも近くの区間だけで、償却 O(log^2 n)）
+//  - 1つの路線に同じ駅は1度だけ。既にある駅の Insert はその駅の移動になる
+class RouteTimeline {
+public:
+  using Route = PersistentList<StationId>;
+  using RevisionId = size_t;
+
+  // 親を持たない基準の版を登録
+  RevisionId AddBase(int year, Route route) {
+    Revision r{year, kNoParent, std::move(route), {}, {}};
+    LabelAll(r);
+    return Push(std::move(r));
+  }
+
+  // 親の版に差分を当てた版を登録
+  RevisionId Record(RevisionId parent, int year,
+                    const std::vector<RouteEdit> &delta) {
+    Revision r = m_revisions[parent];
+    r.year = year;
+    r.parent = parent;
+    for (const auto &e : delta) {
+      if (e.kind == RouteEdit::Kind::Remove) {
+        Remove(r, e.station);
+        continue;
+      }
+      Remove(r, e.station);
+      const size_t a = IndexOf(r, e.after);
+      Insert(r, a < r.route.size() ? a + 1 : r.route.size(), e.station);
+    }
+    return Push(std::move(r));
+  }
+
+  const Route &Lineup(RevisionId id) const { return m_revisions[id].route; }
+  int Year(RevisionId id) const { return m_revisions[id].year; }
+  RevisionId Parent(RevisionId id) const { return m_revisions[id].parent; }
+  size_t RevisionCount() const { return m_revisions.size(); }
+
+  // その年に有効な路線（year 以前で最も新しい版）。無ければ nullptr
+  const Route *LineupAt(int year) const {
+    auto it = m_byYear.upper_bound(year);
+    if (it == m_byYear.begin())
+      return nullptr;
+    return &m_revisions[(--it)->second].route;
+  }
+
+  static constexpr RevisionId kNoParent = static_cast<RevisionId>(-1);
+
+private:
+  using Label = std::uint64_t;
+  static constexpr Label kNoLabel = 0; // 路線に無い駅
+
+  struct Revision {
+    int year;
+    RevisionId parent;
+    Route route;
+    PersistentList<Label> labels;  // route と同じ順。狭義の昇順
+    PersistentList<Label> labelOf; // 駅 ID で引く（無ければ kNoLabel）
+  };
+
+  static Label LabelOf(const Revision &r, StationId id) {
+    return id < r.labelOf.size() ? r.labelOf[id] : kNoLabel;
+  }
+
+  // 駅の位置。無ければ route.size()
+  static size_t IndexOf(const Revision &r, StationId id) {
+    const Label label = LabelOf(r, id);
+    return label == kNoLabel ? r.route.size() : r.labels.LowerBound(label);
+  }
+
+  static void SetLabel(Revision &r, StationId id, Label label) {
+    while (r.labelOf.size() <= id) // 後から登録された駅の分を伸ばす
+      r.labelOf = r.labelOf.Insert(r.labelOf.size(), kNoLabel);
+    r.labelOf = r.labelOf.Set(id, label);
+  }
+
+  static void Remove(Revision &r, StationId id) {
+    const size_t i = IndexOf(r, id);
+    if (i == r.route.size())
+      return;
+    r.route = r.route.Erase(i);
+    r.labels = r.labels.Erase(i);
+    r.labelOf = r.labelOf.Set(id, kNoLabel);
+  }
+
+  // 前後のラベルの中間を振る。隙間が無ければ近くだけ振り直す
+  static void Insert(Revision &r, size_t i, StationId id) {
+    r.route = r.route.Insert(i, id);
+    const Label lo = i > 0 ? r.labels[i - 1] : kNoLabel;
+    const Label hi = i < r.labels.size() ? r.labels[i] : ~Label{0};
+    if (hi - lo >= 2) {
+      const Label label = lo + (hi - lo) / 2;
+      r.labels = r.labels.Insert(i, label);
+      SetLabel(r, id, label);
+      return;
+    }
+    RelabelAround(r, i, i > 0 ? lo : hi);
+  }
+
+  // 隙間が尽きたとき（順序保守の方法）
+  //   anchor を含む 2^l 幅のラベルの区間を l = 1, 2, ... と広げ、入っている
+  //   駅の数が (2 / kDensity)^l 以下になった最初の区間だけを等間隔に振り直す。
+  //   振り直すのはその区間の駅だけなので、1回の挿入あたり償却 O(log n) 件。
+  //   ラベルの列も駅 ID の表も Set で書き換えるので、親の版と構造を共有したまま
+  //   （i には route に入れたばかりの駅がいて、labels にはまだ無い）
+  static void RelabelAround(Revision &r, size_t i, Label anchor) {
+    static constexpr double kDensity = 1.4;
+    double limit = 1.0;
+    for (int level = 1; level <= 64; ++level) {
+      limit *= 2.0 / kDensity;
+      // level == 64 はラベル全体（~0 は「末尾の先」に取っておく）
+      const Label width = level < 64 ? Label{1} << level : ~Label{0};
+      const Label base = level < 64 ? anchor & ~(width - 1) : 0;
+      const size_t first = r.labels.LowerBound(base);
+      const size_t last = level < 64 && base + width != 0
+                              ? r.labels.LowerBound(base + width)
+                              : r.labels.size();
+      const size_t count = last - first + 1; // 新しい駅の分を足す
+      if (level < 64 &&
+          (static_cast<double>(count) > limit || (count + 1) * 2 > width))
+        continue;
+      const Label step = width / (count + 1);
+      r.labels = r.labels.Insert(i, kNoLabel); // 仮。下で振り直す
+      for (size_t k = 0; k < count; ++k) {
+        const Label label = base + step * (k + 1);
+        r.labels = r.labels.Set(first + k, label);
+        SetLabel(r, r.route[first + k], label);
+      }
+      return;
+    }
+  }
+
+  // 路線全体に等間隔のラベルを振る … O(n)（基準の版を登録するときだけ）
+  static void LabelAll(Revision &r) {
+    const Label step = ~Label{0} / (r.route.size() + 1);
+    std::vector<Label> labels;
+    std::vector<Label> labelOf(r.labelOf.size(), kNoLabel);
+    labels.reserve(r.route.size());
+    for (const StationId id : r.route) {
+      const Label label = step * (labels.size() + 1);
+      labels.push_back(label);
+      if (labelOf.size() <= id)
+        labelOf.resize(id + 1, kNoLabel);
+      labelOf[id] = label;
+    }
+    r.labels = PersistentList<Label>(labels.begin(), labels.end());
+    r.labelOf = PersistentList<Label>(labelOf.begin(), labelOf.end());
+  }
+
+  RevisionId Push(Revision r) {
+    const RevisionId id = m_revisions.size();
+    m_byYear[r.year] = id;
+    m_revisions.push_back(std::move(r));
+    return id;
+  }
+
+  std::vector<Revision> m_revisions;
+  std::map<int, RevisionId> m_byYear;
+};
@@ -0,0 +1,96 @@
+// StationRoute.h
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <utility>
+#include <vector>
+
+#include "StationTable.h"
+
+// ==== 駅ID → リストノード の索引付き路線 ====
+//  - 並びは std::list で保持（挿入・削除でイテレータが無効にならない）
+//  - ID は連番なので、索引は ID を添字にした配列で O(1) で引く
+//  - 1路線に同じ駅は1つだけとする
+class StationRoute {
+public:
+  using List = std::list<StationId>;
+  using const_iterator = List::const_iterator;
+
+  StationRoute() = default;
+
+  explicit StationRoute(const List &L) {
+    for (StationId s : L)
+      PushBack(s);
+  }
+
+  // コピー時は索引がコピー元のノードを指さないよう作り直す
+  StationRoute(const StationRoute &other) : StationRoute(other.m_list) {}
+  StationRoute &operator=(const StationRoute &other) {
+    if (this != &other) {
+      StationRoute tmp(other);
+      *this = std::move(tmp);
+    }
+    return *this;
+  }
+
+  // ムーブでは list のノードがそのまま移るので索引も有効なまま
+  StationRoute(StationRoute &&) = default;
+  StationRoute &operator=(StationRoute &&) = default;
+
+  // 末尾に追加（既にあれば何もしない）
+  const_iterator PushBack(StationId id) {
+    return InsertBefore(m_list.end(), id);
+  }
+
+  // after の直後に id を挿入。after が無ければ末尾に追加
+  // （既に id があればそのノードを返し、挿入しない）
+  const_iterator InsertAfter(StationId after, StationId id) {
+    if (!Contains(after))
+      return PushBack(id);
+    return InsertBefore(std::next(m_index[after].it), id);
+  }
+
+  // 一致する駅を削除。削除したら true
+  bool Remove(StationId id) {
+    if (!Contains(id))
+      return false;
+    m_list.erase(m_index[id].it);
+    m_index[id].present = false;
+    return true;
+  }
+
+  // 駅のノードを返す。無ければ end()
+  const_iterator Find(StationId id) const {
+    return Contains(id) ? const_iterator(m_index[id].it) : m_list.end();
+  }
+
+  bool Contains(StationId id) const {
+    return id < m_index.size() && m_index[id].present;
+  }
+
+  const List &Stations() const { return m_list; }
+  size_t size() const { return m_list.size(); }
+  bool empty() const { return m_list.empty(); }
+  const_iterator begin() const { return m_list.begin(); }
+  const_iterator end() const { return m_list.end(); }
+
+private:
+  struct Slot {
+    List::iterator it;
+    bool present = false;
+  };
+
+  const_iterator InsertBefore(List::iterator pos, StationId id) {
+    if (Contains(id))
+      return m_index[id].it;
+    if (id >= m_index.size())
+      m_index.resize(static_cast<size_t>(id) + 1);
+    m_index[id].it = m_list.insert(pos, id);
+    m_index[id].present = true;
+    return m_index[id].it;
+  }
+
+  List m_list;
+  std::vector<Slot> m_index;
+};
@@ -0,0 +1,104 @@
+// StationTable.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // strcmp, memcpy
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// ==== 駅ID ====
+// 駅名を StationTable に登録すると 0 から連番の ID が振られる
+using StationId = std::uint32_t;
+const StationId kNoStation = static_cast<StationId>(-1);
+
+// ==== C文字列をキーにするためのハッシュ／比較 ====
+// ポインタ値ではなく文字列の中身で比較する
+struct CStrHash {
+  size_t operator()(const char *s) const noexcept {
+    // FNV-1a
+    size_t h = static_cast<size_t>(1469598103934665603ull);
+    for (; *s; ++s) {
+      h ^= static_cast<unsigned char>(*s);
+      h *= static_cast<size_t>(1099511628211ull);
+    }
+    return h;
+  }
+};
+
+struct CStrEqual {
+  bool operator()(const char *a, const char *b) const noexcept {
+    return std::strcmp(a, b) == 0;
+  }
+};
+
+// ==== 駅名の intern 表 ====
+//  - 同じ名前には常に同じ ID を返す
+//  - 名前の文字列は表が自前のバッファにコピーして保持する
+//  - 文字列比較は登録時の1回だけで、以降は ID の整数比較で済む
+class StationTable {
+public:
+  StationTable() = default;
+  StationTable(const StationTable &) = delete;
+  StationTable &operator=(const StationTable &) = delete;
+
+  // 名前を登録して ID を返す（登録済みなら既存の ID）
+  StationId Intern(const char *name) {
+    const auto found = m_ids.find(name);
+    if (found != m_ids.end())
+      return found->second;
+    const size_t len = std::strlen(name);
+    const char *copy = Store(name, len + 1);
+    const StationId id = static_cast<StationId>(m_names.size());
+    m_names.push_back(copy);
+    m_lengths.push_back(static_cast<std::uint32_t>(len));
+    m_ids.emplace(copy, id);
+    return id;
+  }
+
+  // 登録済みの ID。未登録なら kNoStation
+  StationId Find(const char *name) const {
+    const auto found = m_ids.find(name);
+    return found == m_ids.end() ? kNoStation : found->second;
+  }
+
+  // ID → 名前（出力時だけ使う）
+  const char *Name(StationId id) const { return m_names[id]; }
+
+  // 名前の長さ（登録時に計算済み。出力の桁揃え・確保量の見積もり用）
+  size_t NameLength(StationId id) const { return m_lengths[id]; }
+
+  size_t size() const { return m_names.size(); }
+
+  void reserve(size_t n) {
+    m_names.reserve(n);
+    m_lengths.reserve(n);
+    m_ids.reserve(n);
+  }
+
+private:
+  static constexpr size_t kChunkSize = 64 * 1024;
+
+  // 名前を文字バッファにコピー（チャンク単位で確保し、アドレスは動かさない）
+  const char *Store(const char *name, size_t len) {
+    if (len > m_chunkLeft) {
+      const size_t size = len > kChunkSize ? len : kChunkSize;
+      m_chunks.emplace_back(new char[size]);
+      m_chunkHead = m_chunks.back().get();
+      m_chunkLeft = size;
+    }
+    char *dst = m_chunkHead;
+    std::memcpy(dst, name, len);
+    m_chunkHead += len;
+    m_chunkLeft -= len;
+    return dst;
+  }
+
+  std::vector<const char *> m_names;
+  std::vector<std::uint32_t> m_lengths;
+  std::unordered_map<const char *, StationId, CStrHash, CStrEqual> m_ids;
+  std::vector<std::unique_ptr<char[]>> m_chunks;
+  char *m_chunkHead = nullptr;
+  size_t m_chunkLeft = 0;
+};
@@ -1,19 +1,33 @@
 // main.cpp
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <cstring> // strcmp
 #include <iomanip>
 #include <iostream>
 #include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "LineupDiff.h"
+#include "OutputBuffer.h"
+#include "RouteTimeline.h"
+#include "StationRoute.h"
 
 // ==== 文字列ユーティリティ：std::string を使わない ====
 static bool StrEq(const char *a, const char *b) {
   return std::strcmp(a, b) == 0;
 }
 
-// リストから一致する駅名を1件削除
-static void RemoveByName(std::list<const char *> &L, const char *name) {
+// ==== 駅の並びは StationId で持ち、名前は表示時だけ引く ====
+using Lineup = std::list<StationId>;
+
+// リストから一致する駅を1件削除
+static void RemoveByName(Lineup &L, StationId name) {
   for (auto it = L.begin(); it != L.end(); ++it) {
-    if (StrEq(*it, name)) {
+    if (*it == name) {
       L.erase(it);
       return;
     }
@@ -21,10 +35,9 @@ static void RemoveByName(std::list<const char *> &L, const char *name) {
 }
 
 // 指定駅 afterName の直後に newName を挿入
-static void InsertAfter(std::list<const char *> &L, const char *afterName,
-                        const char *newName) {
+static void InsertAfter(Lineup &L, StationId afterName, StationId newName) {
   for (auto it = L.begin(); it != L.end(); ++it) {
-    if (StrEq(*it, afterName)) {
+    if (*it == afterName) {
       L.insert(std::next(it), newName);
       return;
     }
@@ -32,32 +45,157 @@ static void InsertAfter(std::list<const char *> &L, const char *afterName,
   L.push_back(newName);
 }
 
-// 1行の矢印並び表示
-static void PrintLineup(const std::list<const char *> &L, const char *title) {
-  std::cout << "===== " << title << " =====\n";
-  size_t i = 0, n = L.size();
-  for (const auto &s : L) {
-    std::cout << s;
+// ==== 出力方法 ====
+//  Stream  : std::cout へトークンごとに書く（従来どおり）
+//  Buffered: 表全体を OutputBuffer に組み立て、1回の write で書き出す
+enum class PrintMode { Stream, Buffered };
+
+// 1行の矢印並び表示（std::list / PersistentList どちらも可）
+template <class Route>
+static void PrintLineup(const StationTable &names, const Route &L,
+                        const char *title, PrintMode mode = PrintMode::Stream,
+                        std::ostream &os = std::cout) {
+  static const char kArrow[] = "  ->  ";
+  const size_t n = L.size();
+
+  if (mode == PrintMode::Buffered) {
+    // 必要なバイト数を先に数えて1回で確保
+    size_t bytes = std::strlen(title) + 16 + (sizeof(kArrow) - 1) * n;
+    for (StationId s : L)
+      bytes += names.NameLength(s);
+
+    OutputBuffer out;
+    out.reserve(bytes);
+    out.Append("===== ");
+    out.Append(title);
+    out.Append(" =====\n");
+    size_t i = 0;
+    for (StationId s : L) {
+      out.Append(names.Name(s), names.NameLength(s));
+      if (++i < n)
+        out.Append(kArrow, sizeof(kArrow) - 1);
+    }
+    out.Append("\n\n");
+    out.Flush(os);
+    return;
+  }
+
+  os << "===== " << title << " =====\n";
+  size_t i = 0;
+  for (StationId s : L) {
+    os << names.Name(s);
     if (++i < n)
-      std::cout << "  ->  ";
+      os << kArrow;
   }
-  std::cout << "\n\n";
+  os << "\n\n";
 }
 
 // 表形式表示
-static void PrintTable(const std::list<const char *> &L, const char *title) {
-  std::cout << "===== " << title << " =====\n";
-  std::cout << "----------------------\n";
+template <class Route>
+static void PrintTable(const StationTable &names, const Route &L,
+                       const char *title, PrintMode mode = PrintMode::Stream,
+                       std::ostream &os = std::cout) {
+  static const char kRule[] = "----------------------\n";
+  const size_t kNoWidth = 4; // 番号列の幅
+
+  if (mode == PrintMode::Buffered) {
+    // 番号列の幅は最大番号の桁数と kNoWidth の大きい方
+    // （setw は長い値を切り詰めないため）
+    const size_t n = L.size();
+    size_t digits = 1;
+    for (size_t v = n; v >= 10; v /= 10)
+      ++digits;
+    const size_t noWidth = digits > kNoWidth ? digits : kNoWidth;
+    size_t bytes = std::strlen(title) + 16 + sizeof(kRule) + (noWidth + 1) * n;
+    for (StationId s : L)
+      bytes += names.NameLength(s);
+
+    OutputBuffer out;
+    out.reserve(bytes);
+    out.Append("===== ");
+    out.Append(title);
+    out.Append(" =====\n");
+    out.Append(kRule, sizeof(kRule) - 1);
+    int no = 1;
+    for (StationId s : L) {
+      out.AppendIntLeft(no++, kNoWidth);
+      out.Append(names.Name(s), names.NameLength(s));
+      out.Append('\n');
+    }
+    out.Append('\n');
+    out.Flush(os);
+    return;
+  }
+
+  os << "===== " << title << " =====\n";
+  os << kRule;
   int no = 1;
-  for (const auto &s : L) {
-    std::cout << std::left << std::setw(4) << no++ << s << "\n";
+  for (StationId s : L) {
+    os << std::left << std::setw(kNoWidth) << no++ << names.Name(s) << "\n";
   }
-  std::cout << "\n";
+  os << "\n";
+}
+
+// ==== 差分表示 ====
+// 要約（例: "+1 by Takanawa Gateway"）
+static void PrintDiffSummary(const StationTable &names, const LineupDiff &diff,
+                             std::ostream &os = std::cout) {
+  if (diff.empty()) {
+    os << "no change";
+    return;
+  }
+  const struct {
+    LineupChange::Kind kind;
+    char sign;
+  } kinds[] = {{LineupChange::Kind::Insert, '+'},
+               {LineupChange::Kind::Remove, '-'},
+               {LineupChange::Kind::Move, '~'}};
+  bool firstGroup = true;
+  for (const auto &k : kinds) {
+    const size_t count = diff.Count(k.kind);
+    if (count == 0)
+      continue;
+    os << (firstGroup ? "" : ", ") << k.sign << count << " by ";
+    firstGroup = false;
+    bool first = true;
+    for (const auto &c : diff.changes) {
+      if (c.kind != k.kind)
+        continue;
+      os << (first ? "" : " / ") << names.Name(c.station);
+      first = false;
+    }
+  }
+}
+
+// 1変更1行の変更レポート
+static void PrintDiffReport(const StationTable &names, const LineupDiff &diff,
+                            const char *title, std::ostream &os = std::cout) {
+  os << "===== " << title << " =====\n";
+  for (const auto &c : diff.changes) {
+    const char *anchor = c.after == kNoStation ? "(head)" : names.Name(c.after);
+    switch (c.kind) {
+    case LineupChange::Kind::Insert:
+      os << "+ " << names.Name(c.station) << "  (after " << anchor << ")\n";
+      break;
+    case LineupChange::Kind::Remove:
+      os << "- " << names.Name(c.station) << "  (was after " << anchor
+         << ")\n";
+      break;
+    case LineupChange::Kind::Move:
+      os << "~ " << names.Name(c.station) << "  (now after " << anchor
+         << ")\n";
+      break;
+    }
+  }
+  os << "kept=" << diff.kept
+     << ", inserted=" << diff.Count(LineupChange::Kind::Insert)
+     << ", removed=" << diff.Count(LineupChange::Kind::Remove)
+     << ", moved=" << diff.Count(LineupChange::Kind::Move) << "\n\n";
 }
 
 // ==== 年代別データ ====
 // 2019年(高輪ゲートウェイ直前)：Nishi-Nippori(1971開業)は含める
-static std::list<const char *> Make2019() {
+static Lineup Make2019(StationTable &names) {
   const char *seq[] = {
       "Tokyo",     "Kanda",      "Akihabara",    "Okachimachi",
       "Ueno",      "Uguisudani", "Nippori",      "Nishi-Nippori",
@@ -67,48 +205,428 @@ static std::list<const char *> Make2019() {
       "Ebisu",     "Meguro",     "Gotanda",      "Osaki",
       "Shinagawa", "Tamachi",    "Hamamatsucho", "Shimbashi",
       "Yurakucho"};
-  std::list<const char *> L;
+  Lineup L;
   for (const char *s : seq)
-    L.push_back(s);
+    L.push_back(names.Intern(s));
   return L;
 }
 
-// 1970: Nishi-Nippori(1971) before opening -> removed from 2019
-static std::list<const char *> Make1970() {
-  auto L = Make2019();
-  RemoveByName(L, "Nishi-Nippori");
-  return L;
+// ==== 年代別の版 ====
+// 2019年を基準とし、他の年は差分として記録する（リストの丸ごとコピーはしない）
+static RouteTimeline MakeYamanoteTimeline(StationTable &names) {
+  RouteTimeline T;
+  const auto L2019 = Make2019(names);
+  const auto base =
+      T.AddBase(2019, RouteTimeline::Route(L2019.begin(), L2019.end()));
+
+  // 1970: Nishi-Nippori(1971) before opening -> removed from 2019
+  T.Record(base, 1970, {RouteEdit::Remove(names.Intern("Nishi-Nippori"))});
+
+  // 2022年：Takanawa Gatewa(2020)を Shinagawa と Tamachi の間へ挿入
+  T.Record(base, 2022,
+           {RouteEdit::InsertAfter(names.Intern("Shinagawa"),
+                                   names.Intern("Takanawa Gateway"))});
+  return T;
 }
 
-// 2022年：Takanawa Gatewa(2020)を Shinagawa と Tamachi の間へ挿入
-static std::list<const char *> Make2022() {
-  auto L = Make2019();
-  InsertAfter(L, "Shinagawa", "Takanawa Gateway"); // 品川の直後に挿入
-  return L;
+// ==== ベンチマーク ====
+// 使い方: 01_01.exe --bench
+using BenchClock = std::chrono::steady_clock;
+
+// 計測ループが最適化で消されないよう結果を書き込む先
+static volatile size_t g_benchSink = 0;
+
+static double ElapsedNs(BenchClock::time_point t0, BenchClock::time_point t1) {
+  return std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+// "S0000001" 形式の駅名を n 個作る（文字列の実体は戻り値が保持）
+static std::vector<std::string> MakeSyntheticNames(size_t n) {
+  std::vector<std::string> names;
+  names.reserve(n);
+  char buf[32];
+  for (size_t i = 0; i < n; ++i) {
+    std::snprintf(buf, sizeof(buf), "S%07zu", i);
+    names.emplace_back(buf);
+  }
+  return names;
+}
+
+// 名前をすべて intern して ID 列にする
+static std::vector<StationId> InternAll(StationTable &table,
+                                        const std::vector<std::string> &names) {
+  std::vector<StationId> ids;
+  ids.reserve(names.size());
+  table.reserve(names.size());
+  for (const auto &s : names)
+    ids.push_back(table.Intern(s.c_str()));
+  return ids;
+}
+
+// 1回の編集 = ランダムな駅を削除し、別のランダムな駅の直後に戻す
+static double BenchLinear(const std::vector<StationId> &ids, size_t ops) {
+  Lineup L(ids.begin(), ids.end());
+
+  std::mt19937 rng(12345);
+  std::uniform_int_distribution<size_t> pick(0, ids.size() - 1);
+  const auto t0 = BenchClock::now();
+  for (size_t i = 0; i < ops; ++i) {
+    const StationId victim = ids[pick(rng)];
+    const StationId anchor = ids[pick(rng)];
+    if (victim == anchor)
+      continue;
+    RemoveByName(L, victim);
+    InsertAfter(L, anchor, victim);
+  }
+  return ElapsedNs(t0, BenchClock::now()) / static_cast<double>(ops);
+}
+
+static double BenchIndexed(const std::vector<StationId> &ids, size_t ops) {
+  StationRoute R;
+  for (StationId id : ids)
+    R.PushBack(id);
+
+  std::mt19937 rng(12345);
+  std::uniform_int_distribution<size_t> pick(0, ids.size() - 1);
+  const auto t0 = BenchClock::now();
+  for (size_t i = 0; i < ops; ++i) {
+    const StationId victim = ids[pick(rng)];
+    const StationId anchor = ids[pick(rng)];
+    if (victim == anchor)
+      continue;
+    R.Remove(victim);
+    R.InsertAfter(anchor, victim);
+  }
+  return ElapsedNs(t0, BenchClock::now()) / static_cast<double>(ops);
+}
+
+// 版の記録：ランダムな駅を削除し、別のランダムな駅の直後に戻す版を重ねる
+//  scan  : 差分を当てるたびに PersistentList を走査して位置を探す（索引なし）
+//  labels: RouteTimeline::Record（順序ラベルで位置を引く）
+static double BenchRecordScan(const std::vector<StationId> &ids, size_t ops) {
+  using Route = RouteTimeline::Route;
+  Route route(ids.begin(), ids.end());
+  const auto indexOf = [](const Route &r, StationId id) {
+    return r.FindIf([id](StationId s) { return s == id; });
+  };
+
+  std::mt19937 rng(4242);
+  std::uniform_int_distribution<size_t> pick(0, ids.size() - 1);
+  const auto t0 = BenchClock::now();
+  for (size_t i = 0; i < ops; ++i) {
+    const StationId victim = ids[pick(rng)];
+    const StationId anchor = ids[pick(rng)];
+    if (victim == anchor)
+      continue;
+    route = route.Erase(indexOf(route, victim));
+    route = route.Insert(indexOf(route, anchor) + 1, victim);
+  }
+  const double ns = ElapsedNs(t0, BenchClock::now());
+  g_benchSink = route.At(0);
+  return ns / static_cast<double>(ops);
+}
+
+static double BenchRecordLabels(const std::vector<StationId> &ids,
+                                size_t ops) {
+  RouteTimeline T;
+  auto rev = T.AddBase(0, RouteTimeline::Route(ids.begin(), ids.end()));
+
+  std::mt19937 rng(4242);
+  std::uniform_int_distribution<size_t> pick(0, ids.size() - 1);
+  const auto t0 = BenchClock::now();
+  for (size_t i = 0; i < ops; ++i) {
+    const StationId victim = ids[pick(rng)];
+    const StationId anchor = ids[pick(rng)];
+    if (victim == anchor)
+      continue;
+    rev = T.Record(rev, static_cast<int>(i + 1),
+                   {RouteEdit::InsertAfter(anchor, victim)});
+  }
+  const double ns = ElapsedNs(t0, BenchClock::now());
+  g_benchSink = T.Lineup(rev).At(0);
+  return ns / static_cast<double>(ops);
+}
+
+// 駅名で指示される編集：名前で渡された駅を削除し、名前で渡された駅の直後に戻す
+//  strcmp     : std::list<const char *> を StrEq で走査（intern 導入前）
+//  interned id: 名前を StationTable::Find で1回だけ ID に引き、
+//               std::list<StationId> を整数比較で走査（RemoveByName / InsertAfter）
+//  どちらも走査は O(n)。回数は比較の総数がそろうよう n に反比例させる
+static size_t NameEditOps(size_t n) {
+  return std::min<size_t>(std::max<size_t>(200000000 / n, 100), 200000);
+}
+
+static double BenchNameEditByString(const std::vector<std::string> &names,
+                                    size_t ops) {
+  // 路線は自分の文字列を持つ（問い合わせの名前とは別の場所にある）
+  const std::vector<std::string> own(names);
+  std::list<const char *> L;
+  for (const auto &s : own)
+    L.push_back(s.c_str());
+  const auto find = [&L](const char *key) {
+    auto it = L.begin();
+    while (it != L.end() && !StrEq(*it, key))
+      ++it;
+    return it;
+  };
+
+  std::mt19937 rng(777);
+  std::uniform_int_distribution<size_t> pick(0, names.size() - 1);
+  const auto t0 = BenchClock::now();
+  for (size_t i = 0; i < ops; ++i) {
+    const char *victim = names[pick(rng)].c_str();
+    const char *anchor = names[pick(rng)].c_str();
+    if (StrEq(victim, anchor))
+      continue;
+    const auto v = find(victim);
+    const char *moved = *v;
+    L.erase(v);
+    L.insert(std::next(find(anchor)), moved);
+  }
+  const double ns = ElapsedNs(t0, BenchClock::now());
+  g_benchSink = std::strlen(L.front());
+  return ns / static_cast<double>(ops);
+}
+
+static double BenchNameEditById(const StationTable &table,
+                                const std::vector<std::string> &names,
+                                const std::vector<StationId> &ids,
+                                size_t ops) {
+  Lineup L(ids.begin(), ids.end());
+
+  std::mt19937 rng(777);
+  std::uniform_int_distribution<size_t> pick(0, names.size() - 1);
+  const auto t0 = BenchClock::now();
+  for (size_t i = 0; i < ops; ++i) {
+    const StationId victim = table.Find(names[pick(rng)].c_str());
+    const StationId anchor = table.Find(names[pick(rng)].c_str());
+    if (victim == anchor)
+      continue;
+    RemoveByName(L, victim);
+    InsertAfter(L, anchor, victim);
+  }
+  const double ns = ElapsedNs(t0, BenchClock::now());
+  g_benchSink = L.front();
+  return ns / static_cast<double>(ops);
+}
+
+// 書き込まれたバイト数だけ数えて捨てる出力先
+class CountingBuf : public std::streambuf {
+public:
+  size_t bytes = 0;
+
+protected:
+  int_type overflow(int_type c) override {
+    ++bytes;
+    return traits_type::not_eof(c);
+  }
+  std::streamsize xsputn(const char *, std::streamsize n) override {
+    bytes += static_cast<size_t>(n);
+    return n;
+  }
+};
+
+// 表出力のスループット（MB/s）
+//  複数年分（years 個）の表を連続で書き出す
+template <class Print>
+static double BenchPrintMBps(Print print, int years, size_t &bytesOut) {
+  CountingBuf sink;
+  std::ostream os(&sink);
+  const auto t0 = BenchClock::now();
+  for (int y = 0; y < years; ++y)
+    print(os);
+  const double ns = ElapsedNs(t0, BenchClock::now());
+  bytesOut = sink.bytes;
+  return static_cast<double>(sink.bytes) / (ns * 1e-9) / (1024.0 * 1024.0);
+}
+
+// n 駅の並びと、それに edits 件ずつ 挿入・削除・移動 を施した並びを作る
+static void MakeDiffPair(size_t n, size_t edits, std::vector<StationId> &a,
+                         std::vector<StationId> &b) {
+  std::mt19937 rng(2024);
+  a.resize(n);
+  for (size_t i = 0; i < n; ++i)
+    a[i] = static_cast<StationId>(i);
+
+  std::vector<char> taken(n, 0); // 削除または移動で元の位置から抜ける駅
+  std::vector<std::pair<size_t, StationId>> placed; // (新しい挿入位置, 駅)
+  std::uniform_int_distribution<size_t> pick(0, n - 1);
+  for (size_t e = 0; e < edits; ++e) {
+    size_t i = pick(rng);
+    while (taken[i])
+      i = pick(rng);
+    taken[i] = 1; // 削除
+    size_t m = pick(rng);
+    while (taken[m])
+      m = pick(rng);
+    taken[m] = 1; // 移動
+    placed.emplace_back(pick(rng), a[m]);
+    placed.emplace_back(pick(rng), static_cast<StationId>(n + e)); // 新駅
+  }
+  std::sort(placed.begin(), placed.end());
+
+  b.clear();
+  b.reserve(n + edits);
+  size_t p = 0;
+  for (size_t i = 0; i < n; ++i) {
+    for (; p < placed.size() && placed[p].first == i; ++p)
+      b.push_back(placed[p].second);
+    if (!taken[i])
+      b.push_back(a[i]);
+  }
+  for (; p < placed.size(); ++p)
+    b.push_back(placed[p].second);
+}
+
+static void RunBenchmarks() {
+  const size_t sizes[] = {1000, 100000, 1000000};
+  std::cout << std::fixed << std::setprecision(1);
+
+  std::cout << "===== RemoveByName + InsertAfter (ns / edit) =====\n";
+  std::cout << std::left << std::setw(10) << "stations" << std::setw(16)
+            << "linear" << std::setw(16) << "indexed"
+            << "speedup\n";
+  for (size_t n : sizes) {
+    StationTable table;
+    const auto ids = InternAll(table, MakeSyntheticNames(n));
+    // 線形探索は1回あたり O(n) なので回数を絞る
+    const double linear = BenchLinear(ids, n >= 100000 ? 200 : 20000);
+    const double indexed = BenchIndexed(ids, 1000000);
+    std::cout << std::left << std::setw(10) << n << std::setw(16) << linear
+              << std::setw(16) << indexed << (linear / indexed) << "x\n";
+  }
+  std::cout << "\n";
+
+  std::cout << "===== RouteTimeline::Record (ns / edit) =====\n";
+  std::cout << std::left << std::setw(10) << "stations" << std::setw(16)
+            << "scan" << std::setw(16) << "labels"
+            << "speedup\n";
+  for (size_t n : sizes) {
+    StationTable table;
+    const auto ids = InternAll(table, MakeSyntheticNames(n));
+    const double scan = BenchRecordScan(ids, n >= 100000 ? 200 : 20000);
+    const double labels = BenchRecordLabels(ids, 100000);
+    std::cout << std::left << std::setw(10) << n << std::setw(16) << scan
+              << std::setw(16) << labels << (scan / labels) << "x\n";
+  }
+  std::cout << "\n";
+
+  std::cout << "===== edit by name (ns / edit) =====\n";
+  std::cout << std::left << std::setw(10) << "stations" << std::setw(16)
+            << "strcmp" << std::setw(16) << "interned id"
+            << "speedup\n";
+  for (size_t n : sizes) {
+    const auto names = MakeSyntheticNames(n);
+    StationTable table;
+    const auto ids = InternAll(table, names);
+    const double before = BenchNameEditByString(names, NameEditOps(n));
+    const double after = BenchNameEditById(table, names, ids, NameEditOps(n));
+    std::cout << std::left << std::setw(10) << n << std::setw(16) << before
+              << std::setw(16) << after << (before / after) << "x\n";
+  }
+
+  std::cout << "\n";
+  std::cout << "===== PrintTable / PrintLineup throughput (MB/s) =====\n";
+  std::cout << std::left << std::setw(10) << "stations" << std::setw(10)
+            << "printer" << std::setw(16) << "iostream" << std::setw(16)
+            << "buffered"
+            << "speedup\n";
+  const size_t printSizes[] = {1000, 100000};
+  for (size_t n : printSizes) {
+    StationTable table;
+    const auto ids = InternAll(table, MakeSyntheticNames(n));
+    const Lineup L(ids.begin(), ids.end());
+    const int years = static_cast<int>(2000000 / n) + 1;
+    size_t bytes = 0;
+
+    const double tableStream = BenchPrintMBps(
+        [&](std::ostream &os) {
+          PrintTable(table, L, "table", PrintMode::Stream, os);
+        },
+        years, bytes);
+    const double tableBuffered = BenchPrintMBps(
+        [&](std::ostream &os) {
+          PrintTable(table, L, "table", PrintMode::Buffered, os);
+        },
+        years, bytes);
+    std::cout << std::left << std::setw(10) << n << std::setw(10) << "table"
+              << std::setw(16) << tableStream << std::setw(16)
+              << tableBuffered << (tableBuffered / tableStream) << "x\n";
+
+    const double lineupStream = BenchPrintMBps(
+        [&](std::ostream &os) {
+          PrintLineup(table, L, "lineup", PrintMode::Stream, os);
+        },
+        years, bytes);
+    const double lineupBuffered = BenchPrintMBps(
+        [&](std::ostream &os) {
+          PrintLineup(table, L, "lineup", PrintMode::Buffered, os);
+        },
+        years, bytes);
+    std::cout << std::left << std::setw(10) << n << std::setw(10) << "lineup"
+              << std::setw(16) << lineupStream << std::setw(16)
+              << lineupBuffered << (lineupBuffered / lineupStream) << "x\n";
+  }
+
+  std::cout << "\n";
+  std::cout << "===== DiffLineups (ms / diff) =====\n";
+  std::cout << std::left << std::setw(10) << "stations" << std::setw(10)
+            << "edits" << std::setw(16) << "time"
+            << "changes\n";
+  const size_t diffSizes[] = {1000, 100000, 1000000};
+  for (size_t n : diffSizes) {
+    const size_t edits = n / 1000;
+    std::vector<StationId> a, b;
+    MakeDiffPair(n, edits, a, b);
+    const auto t0 = BenchClock::now();
+    const LineupDiff diff = DiffLineups(a, b);
+    const double ms = ElapsedNs(t0, BenchClock::now()) * 1e-6;
+    std::cout << std::left << std::setw(10) << n << std::setw(10) << edits
+              << std::setw(16) << ms << diff.changes.size() << "\n";
+  }
 }
 
-int main() {
+int main(int argc, char *argv[]) {
+  if (argc >= 2 && StrEq(argv[1], "--bench")) {
+    RunBenchmarks();
+    return 0;
+  }
+  // 01_01.exe --diff : 年代間の変更レポートも出す
+  const bool showDiff = argc >= 2 && StrEq(argv[1], "--diff");
+
   // === 年代別リスト作成 ===
-  auto L1970 = Make1970();
-  auto L2019 = Make2019();
-  auto L2022 = Make2022();
+  StationTable names;
+  const auto timeline = MakeYamanoteTimeline(names);
+  const auto &L1970 = *timeline.LineupAt(1970);
+  const auto &L2019 = *timeline.LineupAt(2019);
+  const auto &L2022 = *timeline.LineupAt(2022);
 
   // === 駅の並び ===
-  PrintLineup(L1970, "1970 lineup (before Nishi-Nippori)");
-  PrintLineup(L2019, "2019 lineup");
-  PrintLineup(L2022, "2022 lineup (with Takanawa Gateway)");
+  const PrintMode mode = PrintMode::Buffered;
+  PrintLineup(names, L1970, "1970 lineup (before Nishi-Nippori)", mode);
+  PrintLineup(names, L2019, "2019 lineup", mode);
+  PrintLineup(names, L2022, "2022 lineup (with Takanawa Gateway)", mode);
 
   // === 表形式 ===
-  PrintTable(L1970, "1970");
-  PrintTable(L2019, "2019");
-  PrintTable(L2022, "2022");
+  PrintTable(names, L1970, "1970", mode);
+  PrintTable(names, L2019, "2019", mode);
+  PrintTable(names, L2022, "2022", mode);
+
+  // === 年代間の差分 ===
+  const auto diff1970to2019 = DiffLineups(L1970, L2019);
+  const auto diff2019to2022 = DiffLineups(L2019, L2022);
+  if (showDiff) {
+    PrintDiffReport(names, diff1970to2019, "diff 1970 -> 2019");
+    PrintDiffReport(names, diff2019to2022, "diff 2019 -> 2022");
+  }
 
   // === 駅数まとめ ===
   std::cout << "Stations count: "
             << "1970=" << L1970.size() << ", "
             << "2019=" << L2019.size() << ", "
-            << "2022=" << L2022.size()
-            << "  (2019->2022: +1 by Takanawa Gateway)\n";
+            << "2022=" << L2022.size() << "  (2019->2022: ";
+  PrintDiffSummary(names, diff2019to2022);
+  std::cout << ")\n";
 
   return 0;
 }
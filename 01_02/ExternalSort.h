@@ -0,0 +1,476 @@
+// ExternalSort.h
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv> // to_chars
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <new> // bad_alloc
+#include <stdexcept> // length_error
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(_WIN32)
+#include <process.h> // _getpid
+#else
+#include <unistd.h> // getpid
+#endif
+
+#include "RosterSort.h"
+#include "RosterTokenizer.h"
+#include "StudentKey.h"
+
+// ==============================
+//  外部マージソート（メモリに載らない名簿用）
+//   1. 入力を大きなバッファで順に読み、予算内に収まるだけ溜めて並べる
+//   2. 並べた塊（ラン）を一時ファイルへ書き出す
+//   3. ランを敗者木で k-way マージし、"No, student-id, email" 表を出す
+//      （ランが maxFanIn を超えるときは先に途中マージを重ねる）
+//  並び順・出力は通常モードと同じ。ランが1つで済めば一時ファイルは作らない
+// ==============================
+struct ExternalSortOptions {
+  size_t memoryBudget = size_t{256} << 20; // 作業メモリの上限（バイト）
+  std::string tempDir = ".";               // 一時ファイルの置き場所
+  size_t maxFanIn = 64;                    // 1回のマージで開くラン数の上限
+};
+
+namespace external_sort {
+
+// ---- 大きなバッファでまとめて書く ----
+class BufferedWriter {
+public:
+  BufferedWriter(std::FILE *fp, size_t bufferSize) : m_fp(fp) {
+    m_buf.reserve(bufferSize);
+  }
+  ~BufferedWriter() { Flush(); }
+  BufferedWriter(const BufferedWriter &) = delete;
+  BufferedWriter &operator=(const BufferedWriter &) = delete;
+
+  void Write(const void *p, size_t n) {
+    if (m_buf.size() + n > m_buf.capacity()) {
+      Flush();
+      if (n > m_buf.capacity()) {
+        m_ok = m_ok && std::fwrite(p, 1, n, m_fp) == n;
+        return;
+      }
+    }
+    const char *c = static_cast<const char *>(p);
+    m_buf.insert(m_buf.end(), c, c + n);
+  }
+  void Write(std::string_view s) { Write(s.data(), s.size()); }
+  template <class Int> void WriteInt(Int v) {
+    char tmp[24];
+    const auto r = std::to_chars(tmp, tmp + sizeof(tmp), v);
+    Write(tmp, static_cast<size_t>(r.ptr - tmp));
+  }
+
+  bool Flush() {
+    if (!m_buf.empty()) {
+      m_ok = m_ok && std::fwrite(m_buf.data(), 1, m_buf.size(), m_fp) ==
+                         m_buf.size();
+      m_buf.clear();
+    }
+    return m_ok;
+  }
+
+private:
+  std::FILE *m_fp;
+  std::vector<char> m_buf;
+  bool m_ok = true;
+};
+
+// ---- ラン1件 = rank(4byte) + 長さ(4byte) + アドレス ----
+inline void WriteRecord(BufferedWriter &w, std::uint32_t rank,
+                        std::string_view s) {
+  const std::uint32_t len = static_cast<std::uint32_t>(s.size());
+  w.Write(&rank, sizeof(rank));
+  w.Write(&len, sizeof(len));
+  w.Write(s);
+}
+
+// ---- ランを先頭から順に読む ----
+class RunReader {
+public:
+  RunReader(const std::string &path, size_t bufferSize)
+      : m_fp(std::fopen(path.c_str(), "rb")), m_buf(bufferSize) {}
+  ~RunReader() {
+    if (m_fp)
+      std::fclose(m_fp);
+  }
+  RunReader(const RunReader &) = delete;
+  RunReader &operator=(const RunReader &) = delete;
+
+  bool IsOpen() const { return m_fp != nullptr; }
+
+  // 次のレコードへ進む。尽きたら false
+  //  text() はこのリーダーを次に進めるまで有効
+  bool Next() {
+    const size_t kHeader = 2 * sizeof(std::uint32_t);
+    if (!Ensure(kHeader))
+      return m_valid = false;
+    std::uint32_t len;
+    std::memcpy(&m_rank, m_buf.data() + m_pos, sizeof(m_rank));
+    std::memcpy(&len, m_buf.data() + m_pos + sizeof(m_rank), sizeof(len));
+    if (!Ensure(kHeader + len))
+      return m_valid = false;
+    m_text = std::string_view(m_buf.data() + m_pos + kHeader, len);
+    m_pos += kHeader + len;
+    return m_valid = true;
+  }
+
+  bool valid() const { return m_valid; }
+  std::uint32_t rank() const { return m_rank; }
+  std::string_view text() const { return m_text; }
+
+private:
+  // 未読部分を n バイト以上バッファに用意する
+  bool Ensure(size_t n) {
+    if (m_end - m_pos >= n)
+      return true;
+    std::memmove(m_buf.data(), m_buf.data() + m_pos, m_end - m_pos);
+    m_end -= m_pos;
+    m_pos = 0;
+    if (n > m_buf.size())
+      m_buf.resize(n);
+    m_end += std::fread(m_buf.data() + m_end, 1, m_buf.size() - m_end, m_fp);
+    return m_end >= n;
+  }
+
+  std::FILE *m_fp;
+  std::vector<char> m_buf;
+  size_t m_pos = 0, m_end = 0;
+  std::uint32_t m_rank = 0;
+  std::string_view m_text;
+  bool m_valid = false;
+};
+
+// ---- 敗者木 ----
+//  k 本の列の先頭のうち最小のものを O(log k) で更新しながら取り出す
+//  less(a, b): 列 a の先頭が列 b の先頭より前か（尽きた列は最後）
+class LoserTree {
+public:
+  template <class Less> void Build(size_t k, Less less) {
+    m_k = k;
+    m_tree.assign(std::max<size_t>(k, 1), 0);
+    if (k <= 1)
+      return;
+    std::vector<size_t> winner(2 * k);
+    for (size_t i = 0; i < k; ++i)
+      winner[k + i] = i;
+    for (size_t n = k - 1; n >= 1; --n) {
+      size_t a = winner[2 * n], b = winner[2 * n + 1];
+      if (less(b, a))
+        std::swap(a, b);
+      winner[n] = a;
+      m_tree[n] = b;
+    }
+    m_tree[0] = winner[1];
+  }
+
+  size_t Winner() const { return m_tree[0]; }
+
+  // 勝者の列が1つ進んだあとに呼ぶ
+  template <class Less> void Replay(Less less) {
+    size_t cur = m_tree[0];
+    for (size_t n = (m_k + cur) / 2; n >= 1; n /= 2) {
+      if (less(m_tree[n], cur))
+        std::swap(m_tree[n], cur);
+    }
+    m_tree[0] = cur;
+  }
+
+private:
+  size_t m_k = 0;
+  std::vector<size_t> m_tree; // [0] = 勝者、[1..k-1] = 各節点の敗者
+};
+
+// runs をマージし、各レコードを emit(rank, text) へ渡す
+template <class Emit>
+bool MergeRuns(const std::vector<std::string> &runs, size_t bufferSize,
+               Emit emit) {
+  std::vector<std::unique_ptr<RunReader>> readers;
+  for (const auto &path : runs) {
+    readers.push_back(std::make_unique<RunReader>(path, bufferSize));
+    if (!readers.back()->IsOpen())
+      return false;
+    readers.back()->Next();
+  }
+  const auto less = [&readers](size_t a, size_t b) {
+    const RunReader &x = *readers[a], &y = *readers[b];
+    if (!x.valid() || !y.valid())
+      return x.valid() && !y.valid();
+    if (x.rank() != y.rank())
+      return x.rank() < y.rank();
+    if (x.text() != y.text())
+      return x.text() < y.text();
+    return a < b;
+  };
+  LoserTree tree;
+  tree.Build(readers.size(), less);
+  while (!readers.empty()) {
+    RunReader &top = *readers[tree.Winner()];
+    if (!top.valid())
+      break;
+    emit(top.rank(), top.text());
+    top.Next();
+    tree.Replay(less);
+  }
+  return true;
+}
+
+// 表の1行（通常モードの出力と同じ書式）
+inline void WriteRow(BufferedWriter &out, std::uint64_t no, std::uint32_t rank,
+                     std::string_view s) {
+  const StuKey k = UnpackKey(static_cast<std::uint64_t>(rank)
+                             << packed_key::kIndexBits);
+  out.WriteInt(no);
+  if (k.valid) {
+    out.Write(", k", 3);
+    out.WriteInt(k.year);
+    out.Write("g", 1);
+    out.WriteInt(k.num);
+    out.Write(", ", 2);
+  } else {
+    out.Write(", (no-key), ", 12);
+  }
+  out.Write(s);
+  out.Write("\n", 1);
+}
+
+// ---- 一時ファイル（ラン）の名前と後始末 ----
+//  名前は roster_run_<プロセスID>_<通し番号>.tmp。同時に動く別のプロセスや
+//  別の呼び出しと重ならず、既にあるファイルは上書きしない（"x" で新規作成のみ）
+inline std::FILE *CreateRunFile(const std::string &dir, std::string &path) {
+  static std::atomic<unsigned> counter{0};
+#if defined(_WIN32)
+  const long long pid = _getpid();
+#else
+  const long long pid = getpid();
+#endif
+  for (int attempt = 0; attempt < 100; ++attempt) {
+    path = dir + "/roster_run_" + std::to_string(pid) + "_" +
+           std::to_string(counter++) + ".tmp";
+    if (std::FILE *fp = std::fopen(path.c_str(), "wbx"))
+      return fp;
+    if (errno != EEXIST)
+      break;
+  }
+  return nullptr;
+}
+
+// 作ったランのパス。抜けるときに（失敗・例外でも）残りをすべて消す
+struct RunFiles {
+  std::vector<std::string> paths;
+
+  RunFiles() = default;
+  RunFiles(const RunFiles &) = delete;
+  RunFiles &operator=(const RunFiles &) = delete;
+  ~RunFiles() {
+    for (const auto &path : paths)
+      std::remove(path.c_str());
+  }
+};
+
+} // namespace external_sort
+
+// ==============================
+//  inPath を学籍番号順に並べた表を out へ書く
+//   作業メモリはおおむね options.memoryBudget 以内
+//   失敗したら false（error に理由）
+// ==============================
+inline bool ExternalSortRoster(const std::string &inPath, std::FILE *out,
+                               const ExternalSortOptions &options,
+                               std::string &error) {
+  using namespace external_sort;
+
+  std::FILE *in = std::fopen(inPath.c_str(), "rb");
+  if (!in) {
+    error = "ファイルを開けません: " + inPath;
+    return false;
+  }
+
+  // 予算の割り振り：入出力バッファ2本 + 文字列置き場 + 要素ごとの索引
+  const size_t budget = std::max<size_t>(options.memoryBudget, 1 << 20);
+  const size_t ioBytes =
+      std::min<size_t>(std::max<size_t>(budget / 16, 64 * 1024), 8 << 20);
+  const size_t arenaBytes = budget / 2;
+  // 1件あたり string_view(16) + キー(8) + 基数ソートの作業域(8) + 余裕
+  const size_t maxEntries =
+      std::max<size_t>((budget - arenaBytes - 2 * ioBytes) / 40, 1024);
+
+  std::vector<char> arena;
+  std::vector<std::string_view> tokens;
+  std::vector<std::uint64_t> keys;
+  try { // 予算の大半はここで取る。取れなければ予算が大きすぎる
+    arena.reserve(arenaBytes);
+    tokens.reserve(maxEntries);
+    keys.reserve(maxEntries);
+  } catch (const std::bad_alloc &) {
+    std::fclose(in);
+    error = "作業メモリを確保できません（memoryBudget を小さくしてください）";
+    return false;
+  } catch (const std::length_error &) {
+    std::fclose(in);
+    error = "作業メモリを確保できません（memoryBudget を小さくしてください）";
+    return false;
+  }
+  RunFiles runFiles;
+  std::vector<std::string> &runs = runFiles.paths;
+  bool ok = true;
+
+  // 溜めた分を並べ、ランとして書き出す
+  const auto sortTokens = [&]() {
+    keys.clear();
+    for (size_t i = 0; i < tokens.size(); ++i) {
+      keys.push_back(
+          PackKey(ParseKey(tokens[i]), static_cast<std::uint32_t>(i)));
+    }
+    SortPackedKeys(keys, tokens);
+  };
+  const auto spillRun = [&]() {
+    if (tokens.empty())
+      return;
+    sortTokens();
+    std::string path;
+    std::FILE *fp = CreateRunFile(options.tempDir, path);
+    if (!fp) {
+      error = "一時ファイルを作れません: " + path;
+      ok = false;
+      tokens.clear();
+      arena.clear();
+      return;
+    }
+    runs.push_back(path);
+    {
+      BufferedWriter w(fp, ioBytes);
+      for (std::uint64_t k : keys)
+        WriteRecord(w, KeyRank(k), tokens[KeyIndex(k)]);
+      ok = w.Flush() && ok;
+    }
+    ok = std::fclose(fp) == 0 && ok;
+    if (!ok)
+      error = "一時ファイルに書き込めません: " + path;
+    tokens.clear();
+    arena.clear();
+  };
+  const auto addToken = [&](std::string_view t) {
+    if (arena.size() + t.size() > arena.capacity() ||
+        tokens.size() == maxEntries)
+      spillRun();
+    if (t.size() > arena.capacity()) { // 置き場より大きいトークン
+      spillRun();
+      arena.reserve(t.size());
+    }
+    const char *p = arena.data() + arena.size();
+    arena.insert(arena.end(), t.begin(), t.end());
+    tokens.emplace_back(p, t.size());
+  };
+
+  // ---- 1. 読み込みとランの書き出し ----
+  std::vector<char> inBuf(ioBytes);
+  size_t carry = 0; // 前のブロック末尾の書きかけトークン
+  for (;;) {
+    const size_t got =
+        std::fread(inBuf.data() + carry, 1, inBuf.size() - carry, in);
+    const size_t filled = carry + got;
+    const bool eof = got == 0;
+    // 最後の区切り文字までを確定させ、その先は次に回す
+    size_t cut = filled;
+    if (!eof) {
+      while (cut > 0 && !IsRosterDelim(inBuf[cut - 1]))
+        --cut;
+      if (cut == 0 && filled == inBuf.size()) { // 区切りのない巨大トークン
+        inBuf.resize(inBuf.size() * 2);
+        carry = filled;
+        continue;
+      }
+    }
+    ForEachRosterToken(inBuf.data(), inBuf.data() + cut, addToken);
+    if (!ok)
+      break;
+    carry = filled - cut;
+    std::memmove(inBuf.data(), inBuf.data() + cut, carry);
+    if (eof)
+      break;
+  }
+  std::fclose(in);
+  std::vector<char>().swap(inBuf);
+  if (!ok)
+    return false; // ランは runFiles が消す
+
+  BufferedWriter writer(out, ioBytes);
+  std::uint64_t no = 1;
+  static const char kHeaderLine[] = "No, student-id, email\n";
+
+  // ランが1つも要らなかった（全部メモリに載った）
+  if (runs.empty()) {
+    if (tokens.empty()) {
+      error = "データが空です: " + inPath;
+      return false;
+    }
+    sortTokens();
+    writer.Write(kHeaderLine, sizeof(kHeaderLine) - 1);
+    for (std::uint64_t k : keys)
+      WriteRow(writer, no++, KeyRank(k), tokens[KeyIndex(k)]);
+    if (!writer.Flush()) {
+      error = "出力に書き込めません";
+      return false;
+    }
+    return true;
+  }
+  spillRun();
+  std::vector<char>().swap(arena);
+  std::vector<std::string_view>().swap(tokens);
+  std::vector<std::uint64_t>().swap(keys);
+  if (!ok)
+    return false;
+
+  // ---- 2. ランが多すぎれば途中マージで減らす ----
+  const size_t fanIn = std::max<size_t>(options.maxFanIn, 2);
+  const size_t readBytes =
+      std::max<size_t>(budget / (2 * (fanIn + 1)), 64 * 1024);
+  while (ok && runs.size() > fanIn) {
+    const std::vector<std::string> group(runs.begin(), runs.begin() + fanIn);
+    std::string path;
+    std::FILE *fp = CreateRunFile(options.tempDir, path);
+    if (!fp) {
+      error = "一時ファイルを作れません: " + path;
+      ok = false;
+      break;
+    }
+    runs.push_back(path);
+    {
+      BufferedWriter w(fp, readBytes);
+      ok = MergeRuns(group, readBytes,
+                     [&w](std::uint32_t rank, std::string_view s) {
+                       WriteRecord(w, rank, s);
+                     }) &&
+           w.Flush();
+    }
+    ok = std::fclose(fp) == 0 && ok;
+    for (const auto &g : group)
+      std::remove(g.c_str());
+    runs.erase(runs.begin(), runs.begin() + fanIn);
+    if (!ok)
+      error = "途中マージに失敗しました: " + path;
+  }
+
+  // ---- 3. 最終マージ ----
+  if (ok) {
+    writer.Write(kHeaderLine, sizeof(kHeaderLine) - 1);
+    ok = MergeRuns(runs, readBytes,
+                   [&](std::uint32_t rank, std::string_view s) {
+                     WriteRow(writer, no++, rank, s);
+                   }) &&
+         writer.Flush();
+    if (!ok)
+      error = "最終マージに失敗しました";
+  }
+  return ok;
+}
@@ -0,0 +1,118 @@
+// MappedFile.h
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ==============================
+//  読み取り専用のメモリマップトファイル
+//   - ファイル全体をアドレス空間に写し、コピーせずに参照する
+//   - view() が返す string_view は Close（破棄）まで有効
+//   - 空のファイルも開ける（size() == 0）
+// ==============================
+class MappedFile {
+public:
+  MappedFile() = default;
+  ~MappedFile() { Close(); }
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  bool Open(const std::string &path) {
+    Close();
+#if defined(_WIN32)
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                         OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+      return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size)) {
+      Close();
+      return false;
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+    if (m_size == 0)
+      return true;
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0,
+                                   nullptr);
+    if (!m_mapping) {
+      Close();
+      return false;
+    }
+    m_data = static_cast<const char *>(
+        MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+    m_fd = ::open(path.c_str(), O_RDONLY);
+    if (m_fd < 0)
+      return false;
+    struct stat st;
+    if (::fstat(m_fd, &st) != 0) {
+      Close();
+      return false;
+    }
+    m_size = static_cast<size_t>(st.st_size);
+    if (m_size == 0)
+      return true;
+    void *p = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (p != MAP_FAILED) {
+      ::madvise(p, m_size, MADV_SEQUENTIAL);
+      m_data = static_cast<const char *>(p);
+    }
+#endif
+    if (!m_data) {
+      Close();
+      return false;
+    }
+    return true;
+  }
+
+  void Close() {
+#if defined(_WIN32)
+    if (m_data)
+      UnmapViewOfFile(m_data);
+    if (m_mapping)
+      CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE)
+      CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file = INVALID_HANDLE_VALUE;
+#else
+    if (m_data)
+      ::munmap(const_cast<char *>(m_data), m_size);
+    if (m_fd >= 0)
+      ::close(m_fd);
+    m_fd = -1;
+#endif
+    m_data = nullptr;
+    m_size = 0;
+  }
+
+  const char *data() const { return m_data; }
+  size_t size() const { return m_size; }
+  std::string_view view() const { return std::string_view(m_data, m_size); }
+
+private:
+#if defined(_WIN32)
+  HANDLE m_file = INVALID_HANDLE_VALUE;
+  HANDLE m_mapping = nullptr;
+#else
+  int m_fd = -1;
+#endif
+  const char *m_data = nullptr;
+  size_t m_size = 0;
+};
@@ -0,0 +1,76 @@
+// ParallelLoader.h
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "RosterTokenizer.h"
+#include "StudentKey.h"
+
+// ==============================
+//  名簿の並列解析
+//   1. 入力を threads 個にほぼ等分し、境界を次の区切り文字まで進める
+//      （トークンが2つの区間にまたがらない）
+//   2. 各スレッドが自分の区間を分割し、学籍番号キーも解析する
+//   3. 区間の順に連結し、通し番号を付けて PackKey する
+//  結果は1スレッドで SplitRoster + PackKey したものと完全に同じ
+//  links は text を指す string_view、keys は未ソートの詰めたキー
+// ==============================
+inline void ParseRosterParallel(std::string_view text, unsigned threads,
+                                std::vector<std::string_view> &links,
+                                std::vector<std::uint64_t> &keys) {
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  // 1スレッドあたり最低 64KB は任せる（小さい入力でスレッドを立てすぎない）
+  const size_t kMinChunk = 64 * 1024;
+  const size_t maxThreads = std::max<size_t>(1, text.size() / kMinChunk);
+  threads = static_cast<unsigned>(std::min<size_t>(threads, maxThreads));
+
+  const char *begin = text.data();
+  const char *end = begin + text.size();
+  std::vector<const char *> bounds(threads + 1);
+  bounds[0] = begin;
+  bounds[threads] = end;
+  for (unsigned t = 1; t < threads; ++t) {
+    const char *p = begin + text.size() / threads * t;
+    bounds[t] = FindRosterDelim(std::max(p, bounds[t - 1]), end);
+  }
+
+  struct Chunk {
+    std::vector<std::string_view> links;
+    std::vector<StuKey> keys;
+  };
+  std::vector<Chunk> chunks(threads);
+  const auto work = [&](unsigned t) {
+    Chunk &c = chunks[t];
+    ForEachRosterToken(bounds[t], bounds[t + 1], [&c](std::string_view s) {
+      c.links.push_back(s);
+      c.keys.push_back(ParseKey(s));
+    });
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  for (unsigned t = 1; t < threads; ++t)
+    pool.emplace_back(work, t);
+  work(0);
+  for (auto &th : pool)
+    th.join();
+
+  size_t total = links.size();
+  for (const auto &c : chunks)
+    total += c.links.size();
+  links.reserve(total);
+  keys.reserve(total);
+  for (const auto &c : chunks) {
+    for (size_t i = 0; i < c.links.size(); ++i) {
+      keys.push_back(
+          PackKey(c.keys[i], static_cast<std::uint32_t>(links.size())));
+      links.push_back(c.links[i]);
+    }
+  }
+}
@@ -0,0 +1,435 @@
+// RosterIndex.h
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "ExternalSort.h" // BufferedWriter, WriteRow
+#include "MappedFile.h"
+#include "RosterSort.h"
+#include "RosterTokenizer.h"
+#include "StudentKey.h"
+
+// ==============================
+//  並べ替え済み名簿の索引ファイル（追記分だけ取り込む）
+//   名簿は追記されていく前提で、索引には「どこまで取り込んだか」を残す。
+//   2回目以降は追記分（k 件）だけを解析して
+//     - 重複を除く（追記分どうしはハッシュ集合、索引とは区間ごとに二分探索）
+//     - 学籍番号順に並べる O(k log k)
+//     - 並べた k 件を新しい区間として索引の末尾に足す（既存部分は書き直さない）
+//     - 索引の各区間と合流させながら表を出す
+//   区間が kMaxSegments 個たまったら、1区間にまとめて書き直す（compaction）。
+//   全件の解析と並べ替えは索引が無い（または使えない）最初の1回だけ。
+//   取り込み済みの部分が書き換えられていないかは、名簿の先頭と取り込み位置の
+//   直前の kHashBlock バイトのハッシュで確かめる（違えば作り直す）
+//
+//  ファイル形式（リトルエンディアン、そのまま写像して使う）
+//   IndexHeader
+//   区間 × segments:
+//     SegmentHeader
+//     IndexEntry[count]   学籍番号順。offset は区間の文字列領域の中の位置
+//     char text[textBytes]
+//   fileBytes より後ろは書きかけの残り（無視する）
+// ==============================
+namespace roster_index {
+
+const char kMagic[8] = {'P', 'G', '3', 'R', 'I', 'D', 'X', '2'};
+const std::uint64_t kHashBlock = 4096;
+const std::uint64_t kMaxSegments = 8;
+
+struct IndexHeader {
+  char magic[8];
+  std::uint64_t sourceBytes; // 取り込み済みの名簿の先頭からのバイト数
+  std::uint64_t sourceHash;  // SourceHash(名簿, sourceBytes)
+  std::uint64_t segments;
+  std::uint64_t fileBytes; // ヘッダーを含む有効な長さ
+};
+
+struct SegmentHeader {
+  std::uint64_t count;
+  std::uint64_t textBytes;
+};
+
+struct IndexEntry {
+  std::uint32_t rank; // KeyRank（キーなしフラグ・year・num）
+  std::uint32_t len;
+  std::uint64_t offset;
+};
+
+// 名簿の先頭 kHashBlock バイトと、sourceBytes の直前 kHashBlock バイトの
+// FNV-1a（同じ大きさ以上に書き直された名簿を見分ける）
+inline std::uint64_t SourceHash(std::string_view roster,
+                                std::uint64_t sourceBytes) {
+  const auto fnv = [](const char *p, std::uint64_t n, std::uint64_t h) {
+    for (std::uint64_t i = 0; i < n; ++i) {
+      h ^= static_cast<unsigned char>(p[i]);
+      h *= 1099511628211ull;
+    }
+    return h;
+  };
+  const std::uint64_t block = std::min(kHashBlock, sourceBytes);
+  std::uint64_t h = fnv(roster.data(), block, 14695981039346656037ull);
+  h = fnv(roster.data() + (sourceBytes - block), block, h);
+  return fnv(reinterpret_cast<const char *>(&sourceBytes), sizeof(sourceBytes),
+             h);
+}
+
+// 索引の区間1つを読むための窓
+class SegmentView {
+public:
+  // [p, p + avail) の先頭の区間を読む。形式が正しければ true で、
+  // used に区間のバイト数を入れる
+  bool Attach(const char *p, std::uint64_t avail, std::uint64_t &used) {
+    if (avail < sizeof(SegmentHeader))
+      return false;
+    SegmentHeader header;
+    std::memcpy(&header, p, sizeof(header));
+    avail -= sizeof(SegmentHeader);
+    // count * sizeof(IndexEntry) があふれないように割り算で比べる
+    if (header.count > avail / sizeof(IndexEntry))
+      return false;
+    const std::uint64_t entryBytes = header.count * sizeof(IndexEntry);
+    if (header.textBytes > avail - entryBytes)
+      return false;
+    m_count = static_cast<size_t>(header.count);
+    m_entries = p + sizeof(SegmentHeader);
+    m_text = m_entries + entryBytes;
+    for (size_t i = 0; i < m_count; ++i) {
+      const IndexEntry e = Entry(i);
+      if (e.offset > header.textBytes || e.len > header.textBytes - e.offset)
+        return false;
+    }
+    used = sizeof(SegmentHeader) + entryBytes + header.textBytes;
+    return true;
+  }
+
+  size_t size() const { return m_count; }
+
+  IndexEntry Entry(size_t i) const {
+    IndexEntry e;
+    std::memcpy(&e, m_entries + i * sizeof(IndexEntry), sizeof(e));
+    return e;
+  }
+  std::string_view Text(const IndexEntry &e) const {
+    return std::string_view(m_text + e.offset, e.len);
+  }
+
+  // (rank, text) がこの区間にあるか … O(log n)
+  bool Contains(std::uint32_t rank, std::string_view text) const {
+    size_t lo = 0, hi = size();
+    while (lo < hi) {
+      const size_t mid = lo + (hi - lo) / 2;
+      const IndexEntry e = Entry(mid);
+      if (e.rank < rank || (e.rank == rank && Text(e) < text))
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    if (lo == size())
+      return false;
+    const IndexEntry e = Entry(lo);
+    return e.rank == rank && Text(e) == text;
+  }
+
+private:
+  size_t m_count = 0;
+  const char *m_entries = nullptr;
+  const char *m_text = nullptr;
+};
+
+// 写像した索引ファイルを読むための窓
+class IndexView {
+public:
+  // 形式が正しければ true（長さ・位置はすべて範囲を確かめる）
+  bool Attach(const MappedFile &file) {
+    m_segments.clear();
+    if (file.size() < sizeof(IndexHeader))
+      return false;
+    std::memcpy(&m_header, file.data(), sizeof(m_header));
+    if (std::memcmp(m_header.magic, kMagic, sizeof(kMagic)) != 0)
+      return false;
+    if (m_header.fileBytes < sizeof(IndexHeader) ||
+        m_header.fileBytes > file.size() || m_header.segments == 0 ||
+        m_header.segments > kMaxSegments)
+      return false;
+    std::uint64_t pos = sizeof(IndexHeader);
+    for (std::uint64_t i = 0; i < m_header.segments; ++i) {
+      SegmentView segment;
+      std::uint64_t used = 0;
+      if (!segment.Attach(file.data() + pos, m_header.fileBytes - pos, used))
+        return false;
+      pos += used;
+      m_segments.push_back(segment);
+    }
+    return pos == m_header.fileBytes;
+  }
+
+  std::uint64_t sourceBytes() const { return m_header.sourceBytes; }
+  std::uint64_t sourceHash() const { return m_header.sourceHash; }
+  std::uint64_t fileBytes() const { return m_header.fileBytes; }
+  const std::vector<SegmentView> &segments() const { return m_segments; }
+
+  size_t size() const {
+    size_t n = 0;
+    for (const SegmentView &s : m_segments)
+      n += s.size();
+    return n;
+  }
+
+  // (rank, text) が索引にあるか … O(区間数 × log n)
+  bool Contains(std::uint32_t rank, std::string_view text) const {
+    for (const SegmentView &s : m_segments) {
+      if (s.Contains(rank, text))
+        return true;
+    }
+    return false;
+  }
+
+private:
+  IndexHeader m_header = {};
+  std::vector<SegmentView> m_segments;
+};
+
+// 並べ替え済みの (rank, text) 列を区間として書く
+//   forEach(visit) が visit(rank, text) を学籍番号順に呼ぶこと
+template <class ForEach>
+void WriteSegment(external_sort::BufferedWriter &w, std::uint64_t count,
+                  std::uint64_t textBytes, ForEach forEach) {
+  const SegmentHeader header = {count, textBytes};
+  w.Write(&header, sizeof(header));
+  std::uint64_t offset = 0;
+  forEach([&](std::uint32_t rank, std::string_view s) {
+    const IndexEntry e = {rank, static_cast<std::uint32_t>(s.size()), offset};
+    w.Write(&e, sizeof(e));
+    offset += s.size();
+  });
+  forEach([&](std::uint32_t, std::string_view s) { w.Write(s); });
+}
+
+inline bool SeekTo(std::FILE *fp, std::uint64_t pos) {
+#if defined(_WIN32)
+  return _fseeki64(fp, static_cast<long long>(pos), SEEK_SET) == 0;
+#else
+  return fseeko(fp, static_cast<off_t>(pos), SEEK_SET) == 0;
+#endif
+}
+
+} // namespace roster_index
+
+// ==============================
+//  名簿 rosterPath を索引 indexPath に取り込み、重複を除いた表を out へ書く
+//   索引が無い・壊れている・名簿が縮んだ（書き換えられた）場合は
+//   最初から作り直す
+//   失敗したら false（error に理由）
+// ==============================
+inline bool UpdateRosterIndex(const std::string &rosterPath,
+                              const std::string &indexPath, std::FILE *out,
+                              std::string &error) {
+  using namespace roster_index;
+  using external_sort::BufferedWriter;
+
+  MappedFile roster;
+  if (!roster.Open(rosterPath)) {
+    error = "ファイルを開けません: " + rosterPath;
+    return false;
+  }
+
+  MappedFile indexFile;
+  IndexView index;
+  const bool haveIndex =
+      indexFile.Open(indexPath) && index.Attach(indexFile) &&
+      index.sourceBytes() <= roster.size() &&
+      SourceHash(roster.view(), index.sourceBytes()) == index.sourceHash();
+  const size_t from = haveIndex ? static_cast<size_t>(index.sourceBytes()) : 0;
+
+  // ---- 追記分を解析 ----
+  //  区切りで終わっていない最後のトークンは表には出すが索引には入れず、
+  //  次回もう一度読む（その後ろに続きが追記されても途中で切れない）
+  const std::string_view delta = roster.view().substr(from);
+  size_t consumed = delta.size();
+  while (consumed > 0 && !IsRosterDelim(delta[consumed - 1]))
+    --consumed;
+
+  std::vector<std::string_view> added;
+  std::vector<std::uint64_t> keys;
+  std::unordered_set<std::string_view> seen;
+  const auto addToken = [&](std::string_view t) {
+    if (!seen.insert(t).second)
+      return; // 追記分の中での重複
+    const std::uint64_t k =
+        PackKey(ParseKey(t), static_cast<std::uint32_t>(added.size()));
+    if (haveIndex && index.Contains(KeyRank(k), t))
+      return; // 取り込み済み
+    keys.push_back(k);
+    added.push_back(t);
+  };
+  ForEachRosterToken(delta.data(), delta.data() + consumed, addToken);
+  const size_t indexedCount = added.size(); // これより後ろは索引に入れない
+  ForEachRosterToken(delta.data() + consumed, delta.data() + delta.size(),
+                     addToken);
+  SortPackedKeys(keys, added);
+  // 同じアドレスは隣り合うので、並べ替え後は区間の重複も起きない
+
+  if (!haveIndex && added.empty()) {
+    error = "データが空です: " + rosterPath;
+    return false;
+  }
+
+  // ---- 索引の各区間と追記分を合流させる ----
+  //  visit(rank, text) を学籍番号順に呼ぶ。indexedOnly なら
+  //  最後の区切りより後ろのトークンを飛ばす
+  const size_t segmentCount = haveIndex ? index.segments().size() : 0;
+  const auto forEachMerged = [&](bool indexedOnly, auto visit) {
+    std::vector<size_t> pos(segmentCount, 0);
+    size_t j = 0;
+    for (;;) {
+      if (indexedOnly) {
+        while (j < keys.size() && KeyIndex(keys[j]) >= indexedCount)
+          ++j;
+      }
+      // 先頭が最も小さいもの（区間の数は kMaxSegments 以下なので線形に探す）
+      int best = -1; // -1 … 追記分、それ以外 … 区間の番号
+      std::uint32_t bestRank = 0;
+      std::string_view bestText;
+      bool any = false;
+      if (j < keys.size()) {
+        bestRank = KeyRank(keys[j]);
+        bestText = added[KeyIndex(keys[j])];
+        any = true;
+      }
+      for (size_t s = 0; s < segmentCount; ++s) {
+        const SegmentView &segment = index.segments()[s];
+        if (pos[s] == segment.size())
+          continue;
+        const IndexEntry e = segment.Entry(pos[s]);
+        const std::string_view text = segment.Text(e);
+        if (!any || e.rank < bestRank ||
+            (e.rank == bestRank && text < bestText)) {
+          best = static_cast<int>(s);
+          bestRank = e.rank;
+          bestText = text;
+          any = true;
+        }
+      }
+      if (!any)
+        break;
+      visit(bestRank, bestText);
+      if (best < 0)
+        ++j;
+      else
+        ++pos[static_cast<size_t>(best)];
+    }
+  };
+
+  // 表の出力
+  {
+    static const char kHeaderLine[] = "No, student-id, email\n";
+    BufferedWriter writer(out, 1 << 20);
+    writer.Write(kHeaderLine, sizeof(kHeaderLine) - 1);
+    std::uint64_t no = 1;
+    forEachMerged(false, [&](std::uint32_t rank, std::string_view s) {
+      external_sort::WriteRow(writer, no++, rank, s);
+    });
+    if (!writer.Flush()) {
+      error = "出力に書き込めません";
+      return false;
+    }
+  }
+
+  // 取り込むものが無く、取り込み位置も変わらなければ索引はそのまま
+  const std::uint64_t sourceBytes = from + consumed;
+  if (haveIndex && indexedCount == 0 && sourceBytes == index.sourceBytes())
+    return true;
+
+  IndexHeader header = {};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.sourceBytes = sourceBytes;
+  header.sourceHash = SourceHash(roster.view(), sourceBytes);
+  std::uint64_t addedBytes = 0;
+  for (size_t i = 0; i < indexedCount; ++i)
+    addedBytes += added[i].size();
+  const auto forEachAdded = [&](auto visit) {
+    for (const std::uint64_t k : keys) {
+      if (KeyIndex(k) < indexedCount)
+        visit(KeyRank(k), added[KeyIndex(k)]);
+    }
+  };
+
+  // ---- 追記：新しい区間を末尾に足してからヘッダーを書き換える ----
+  //  ヘッダーより前に落ちても、古いヘッダーのまま（足した分は無視される）
+  if (haveIndex && segmentCount < kMaxSegments) {
+    const std::uint64_t oldBytes = index.fileBytes();
+    header.segments = segmentCount + (indexedCount > 0 ? 1 : 0);
+    header.fileBytes = oldBytes;
+    if (indexedCount > 0) {
+      header.fileBytes += sizeof(SegmentHeader) +
+                          indexedCount * sizeof(IndexEntry) + addedBytes;
+    }
+    // 写像を外してから書く（Windows では写像中のファイルに書けない）
+    indexFile.Close();
+    std::FILE *fp = std::fopen(indexPath.c_str(), "r+b");
+    bool ok = fp != nullptr;
+    if (ok && indexedCount > 0) {
+      ok = SeekTo(fp, oldBytes);
+      BufferedWriter w(fp, 1 << 20);
+      if (ok)
+        WriteSegment(w, indexedCount, addedBytes, forEachAdded);
+      ok = w.Flush() && ok;
+      ok = ok && std::fflush(fp) == 0;
+    }
+    if (ok) {
+      ok = SeekTo(fp, 0) &&
+           std::fwrite(&header, sizeof(header), 1, fp) == 1;
+    }
+    if (fp)
+      ok = std::fclose(fp) == 0 && ok;
+    if (!ok)
+      error = "索引を更新できません: " + indexPath;
+    return ok;
+  }
+
+  // ---- 作り直し・まとめ直し：全体を1区間にして .tmp に書き、差し替える ----
+  const std::string tmpPath = indexPath + ".tmp";
+  std::FILE *fp = std::fopen(tmpPath.c_str(), "wb");
+  if (!fp) {
+    error = "索引を書けません: " + tmpPath;
+    return false;
+  }
+  bool ok = true;
+  {
+    std::uint64_t count = 0, textBytes = 0;
+    forEachMerged(true, [&](std::uint32_t, std::string_view s) {
+      ++count;
+      textBytes += s.size();
+    });
+    header.segments = 1;
+    header.fileBytes = sizeof(IndexHeader) + sizeof(SegmentHeader) +
+                       count * sizeof(IndexEntry) + textBytes;
+    BufferedWriter w(fp, 1 << 20);
+    w.Write(&header, sizeof(header));
+    WriteSegment(w, count, textBytes, [&](auto visit) {
+      forEachMerged(true, visit);
+    });
+    ok = w.Flush();
+  }
+  ok = std::fclose(fp) == 0 && ok;
+
+  // 写像を外してから置き換える（Windows では写像中のファイルを消せない）
+  indexFile.Close();
+  if (ok) {
+    std::remove(indexPath.c_str());
+    ok = std::rename(tmpPath.c_str(), indexPath.c_str()) == 0;
+  }
+  if (!ok) {
+    std::remove(tmpPath.c_str());
+    error = "索引を更新できません: " + indexPath;
+  }
+  return ok;
+}
@@ -0,0 +1,90 @@
+// RosterSort.h
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "StudentKey.h"
+
+// ==============================
+//  詰めたキーの LSD 基数ソート
+//   - 上位32bit（学籍番号の順位）だけを 8bit ずつ4パスで並べる
+//   - LSD は安定なので、同順位の中は入力順（下位32bitの添字順）のまま
+//   - 全要素が同じバケットに入る桁（常に 0 の最上位バイトなど）は飛ばす
+// ==============================
+inline void RadixSortByRank(std::vector<std::uint64_t> &keys) {
+  const size_t n = keys.size();
+  if (n < 2)
+    return;
+
+  const int kPasses = 4;
+  const int kFirstShift = packed_key::kIndexBits;
+  size_t count[kPasses][256] = {};
+  for (std::uint64_t k : keys) {
+    for (int p = 0; p < kPasses; ++p)
+      ++count[p][(k >> (kFirstShift + 8 * p)) & 0xFF];
+  }
+
+  std::vector<std::uint64_t> tmp(n);
+  std::uint64_t *src = keys.data();
+  std::uint64_t *dst = tmp.data();
+  for (int p = 0; p < kPasses; ++p) {
+    const int shift = kFirstShift + 8 * p;
+    if (count[p][(src[0] >> shift) & 0xFF] == n)
+      continue;
+
+    size_t offset[256];
+    size_t sum = 0;
+    for (int b = 0; b < 256; ++b) {
+      offset[b] = sum;
+      sum += count[p][b];
+    }
+    for (size_t i = 0; i < n; ++i)
+      dst[offset[(src[i] >> shift) & 0xFF]++] = src[i];
+    std::swap(src, dst);
+  }
+  if (src != keys.data())
+    std::copy(src, src + n, keys.data());
+}
+
+// ==============================
+//  PackKey 済みのキー列を学籍番号 昇順に並べる
+//   - 並び順は従来の比較関数と同じ：
+//     キーあり → year → num → アドレス文字列、キーなしは文字列順
+//   - 文字列比較は同じ学籍番号どうし（通常は1件）の中でだけ行う
+//   v は KeyIndex が指す元の文字列列
+// ==============================
+template <class Str>
+void SortPackedKeys(std::vector<std::uint64_t> &keys,
+                    const std::vector<Str> &v) {
+  RadixSortByRank(keys);
+
+  // 同順位の区間だけ文字列で並べ直す
+  const auto byString = [&v](std::uint64_t a, std::uint64_t b) {
+    return v[KeyIndex(a)] < v[KeyIndex(b)];
+  };
+  for (size_t lo = 0; lo < keys.size();) {
+    size_t hi = lo + 1;
+    while (hi < keys.size() && KeyRank(keys[hi]) == KeyRank(keys[lo]))
+      ++hi;
+    if (hi - lo > 1)
+      std::sort(keys.begin() + lo, keys.begin() + hi, byString);
+    lo = hi;
+  }
+}
+
+// ==============================
+//  学籍番号 昇順に並べた詰めたキー列を返す
+//   アドレスの解析は各要素につき1回だけ
+//  結果の KeyIndex(k) が v の添字、UnpackKey(k) が学籍番号
+// ==============================
+template <class Str>
+std::vector<std::uint64_t> SortKeysByStuId(const std::vector<Str> &v) {
+  std::vector<std::uint64_t> keys(v.size());
+  for (size_t i = 0; i < v.size(); ++i)
+    keys[i] = PackKey(ParseKey(v[i]), static_cast<std::uint32_t>(i));
+  SortPackedKeys(keys, v);
+  return keys;
+}
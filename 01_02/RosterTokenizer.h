@@ -0,0 +1,68 @@
+// RosterTokenizer.h
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "Simd.h"
+
+// ==============================
+//  名簿の区切り文字での分割（コピーなし）
+//   区切り: , ; と空白類（' ' \t \n \v \f \r。std::isspace と同じ集合）
+//   トークンは元のバッファを指す string_view で返す
+// ==============================
+inline bool IsRosterDelim(char c) {
+  return c == ',' || c == ';' || c == ' ' ||
+         static_cast<unsigned char>(c - '\t') <= '\r' - '\t';
+}
+
+// [p, end) で最初の区切り文字の位置（無ければ end）
+inline const char *FindRosterDelim(const char *p, const char *end) {
+#if defined(ROSTER_SIMD)
+  const __m128i vComma = _mm_set1_epi8(',');
+  const __m128i vSemi = _mm_set1_epi8(';');
+  const __m128i vSpace = _mm_set1_epi8(' ');
+  const __m128i vLo = _mm_set1_epi8('\t' - 1);
+  const __m128i vHi = _mm_set1_epi8('\r' + 1);
+  for (; end - p >= 16; p += 16) {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    // \t..\r の範囲判定。0x80 以上は符号付きで負になるので範囲外になる
+    const __m128i ctrl =
+        _mm_and_si128(_mm_cmpgt_epi8(x, vLo), _mm_cmplt_epi8(x, vHi));
+    const __m128i hit = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(x, vComma), _mm_cmpeq_epi8(x, vSemi)),
+        _mm_or_si128(_mm_cmpeq_epi8(x, vSpace), ctrl));
+    const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+    if (mask)
+      return p + LowestBit(mask);
+  }
+#endif
+  while (p < end && !IsRosterDelim(*p))
+    ++p;
+  return p;
+}
+
+// [p, end) のトークンを順に emit(std::string_view) へ渡す
+template <class Emit>
+void ForEachRosterToken(const char *p, const char *end, Emit emit) {
+  while (p < end) {
+    // 区切りの連続は短いのでスカラーで飛ばす
+    while (p < end && IsRosterDelim(*p))
+      ++p;
+    if (p == end)
+      break;
+    const char *tokenEnd = FindRosterDelim(p, end);
+    emit(std::string_view(p, static_cast<size_t>(tokenEnd - p)));
+    p = tokenEnd;
+  }
+}
+
+// text を分割して out の末尾に追加する。追加した件数を返す
+inline size_t SplitRoster(std::string_view text,
+                          std::vector<std::string_view> &out) {
+  const size_t before = out.size();
+  ForEachRosterToken(text.data(), text.data() + text.size(),
+                     [&out](std::string_view t) { out.push_back(t); });
+  return out.size() - before;
+}
@@ -0,0 +1,24 @@
+// Simd.h
+#pragma once
+
+// SSE2 は x64 なら常に使える。AVX2 は /arch:AVX2（-mavx2）のときだけ使う
+#if defined(_M_X64) || defined(__SSE2__)
+#define ROSTER_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(ROSTER_SIMD)
+// movemask の結果で最も下位の立っているビット位置（mask != 0）
+inline int LowestBit(unsigned mask) {
+#if defined(_MSC_VER)
+  unsigned long i;
+  _BitScanForward(&i, mask);
+  return static_cast<int>(i);
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+#endif
@@ -0,0 +1,183 @@
+// StudentKey.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <regex>
+#include <string>
+#include <string_view>
+
+#include "Simd.h"
+
+// ==============================
+//  学籍番号キー抽出
+// ==============================
+struct StuKey {
+  int year = 0; // kの後ろ3桁
+  int num = 0;  // gの後ろ4桁
+  bool valid = false;
+};
+
+// 正規表現版（k(\d{3})g(\d{4})@ を大文字小文字無視で探す）
+//  ScanKey と同じ結果になることを --verify で確かめるための基準実装
+inline StuKey ParseKeyRegex(const std::string &mail) {
+  static const std::regex re(R"(k(\d{3})g(\d{4})@)", std::regex::icase);
+  std::smatch m;
+  StuKey key;
+  if (std::regex_search(mail, m, re) && m.size() >= 3) {
+    key.year = std::stoi(m[1].str());
+    key.num = std::stoi(m[2].str());
+    key.valid = true;
+  }
+  return key;
+}
+
+// ==============================
+//  正規表現を使わない走査
+//   一致は必ず10文字（k ddd g dddd @）なので、最も左の一致は
+//   「条件を満たす最も左の '@'」で決まる。
+//   SIMD で '@' と9文字前の k/K を16/32文字ずつまとめて調べ、
+//   候補の位置だけ数字をスカラーで確かめる。ヒープ確保はしない
+// ==============================
+namespace key_scan {
+const size_t kMatchLen = 10; // "k123g4567@"
+const size_t kAtOffset = kMatchLen - 1;
+
+inline bool IsDigit(char c) {
+  return static_cast<unsigned char>(c - '0') < 10;
+}
+// 英字に 0x20 を OR すると小文字になる（'k' になるのは k/K だけ）
+inline bool IsLetter(char c, char lower) { return (c | 0x20) == lower; }
+
+// '@' の位置 at で一致するか調べ、一致すれば key に書く
+inline bool MatchAt(const char *s, size_t at, StuKey &key) {
+  const char *m = s + at - kAtOffset;
+  if (!IsLetter(m[0], 'k') || !IsLetter(m[4], 'g'))
+    return false;
+  for (int i : {1, 2, 3, 5, 6, 7, 8}) {
+    if (!IsDigit(m[i]))
+      return false;
+  }
+  key.year = (m[1] - '0') * 100 + (m[2] - '0') * 10 + (m[3] - '0');
+  key.num = (m[5] - '0') * 1000 + (m[6] - '0') * 100 + (m[7] - '0') * 10 +
+            (m[8] - '0');
+  key.valid = true;
+  return true;
+}
+
+inline StuKey ScanScalar(const char *s, size_t n, size_t from = kAtOffset) {
+  StuKey key;
+  for (size_t at = from; at < n; ++at) {
+    if (s[at] == '@' && MatchAt(s, at, key))
+      break;
+  }
+  return key;
+}
+
+#if defined(ROSTER_SIMD)
+// mask の立っている位置（at + bit）を左から確かめる
+inline bool MatchMask(const char *s, size_t at, unsigned mask, StuKey &key) {
+  while (mask) {
+    if (MatchAt(s, at + LowestBit(mask), key))
+      return true;
+    mask &= mask - 1;
+  }
+  return false;
+}
+
+inline StuKey ScanSimd(const char *s, size_t n) {
+  StuKey key;
+  size_t at = kAtOffset;
+#if defined(__AVX2__)
+  {
+    const __m256i vAt = _mm256_set1_epi8('@');
+    const __m256i vK = _mm256_set1_epi8('k');
+    const __m256i vLower = _mm256_set1_epi8(0x20);
+    for (; at + 32 <= n; at += 32) {
+      const __m256i a =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + at));
+      const __m256i k = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i *>(s + at - kAtOffset));
+      const __m256i hit =
+          _mm256_and_si256(_mm256_cmpeq_epi8(a, vAt),
+                           _mm256_cmpeq_epi8(_mm256_or_si256(k, vLower), vK));
+      const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hit));
+      if (mask && MatchMask(s, at, mask, key))
+        return key;
+    }
+  }
+#endif
+  const __m128i vAt = _mm_set1_epi8('@');
+  const __m128i vK = _mm_set1_epi8('k');
+  const __m128i vLower = _mm_set1_epi8(0x20);
+  for (; at + 16 <= n; at += 16) {
+    const __m128i a =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + at));
+    const __m128i k = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(s + at - kAtOffset));
+    const __m128i hit = _mm_and_si128(
+        _mm_cmpeq_epi8(a, vAt), _mm_cmpeq_epi8(_mm_or_si128(k, vLower), vK));
+    const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+    if (mask && MatchMask(s, at, mask, key))
+      return key;
+  }
+  return ScanScalar(s, n, at);
+}
+#endif
+} // namespace key_scan
+
+// s[0..n) から学籍番号キーを探す（ParseKeyRegex と同じ結果）
+inline StuKey ScanKey(const char *s, size_t n) {
+#if defined(ROSTER_SIMD)
+  return key_scan::ScanSimd(s, n);
+#else
+  return key_scan::ScanScalar(s, n);
+#endif
+}
+
+inline StuKey ParseKey(std::string_view mail) {
+  return ScanKey(mail.data(), mail.size());
+}
+
+// ==============================
+//  64bit に詰めたソートキー
+//   bit 56      : キーなしフラグ（キーありを先に並べるため 0 = あり）
+//   bit 46..55  : year（10bit, 0..999）
+//   bit 32..45  : num （14bit, 0..9999）
+//   bit  0..31  : 入力中の添字（同じ学籍番号どうしの並べ直しに使う）
+//  整数として比較すると「キーあり → year → num」の順になる
+// ==============================
+namespace packed_key {
+const int kIndexBits = 32;
+const int kNumShift = 32;
+const int kYearShift = 46;
+const int kInvalidShift = 56;
+} // namespace packed_key
+
+inline std::uint64_t PackKey(const StuKey &k, std::uint32_t index) {
+  using namespace packed_key;
+  if (!k.valid)
+    return (std::uint64_t{1} << kInvalidShift) | index;
+  return (static_cast<std::uint64_t>(k.year) << kYearShift) |
+         (static_cast<std::uint64_t>(k.num) << kNumShift) | index;
+}
+
+// 添字を除いた部分（学籍番号の順位）
+inline std::uint32_t KeyRank(std::uint64_t packed) {
+  return static_cast<std::uint32_t>(packed >> packed_key::kIndexBits);
+}
+
+inline std::uint32_t KeyIndex(std::uint64_t packed) {
+  return static_cast<std::uint32_t>(packed);
+}
+
+inline StuKey UnpackKey(std::uint64_t packed) {
+  using namespace packed_key;
+  StuKey k;
+  k.valid = ((packed >> kInvalidShift) & 1u) == 0;
+  if (k.valid) {
+    k.year = static_cast<int>((packed >> kYearShift) & 0x3FFu);
+    k.num = static_cast<int>((packed >> kNumShift) & 0x3FFFu);
+  }
+  return k;
+}
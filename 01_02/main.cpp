@@ -1,12 +1,28 @@
 // main.cpp
 #include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdint> // SIZE_MAX
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
-#include <regex>
+#include <random>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
+#include "ExternalSort.h"
+#include "MappedFile.h"
+#include "ParallelLoader.h"
+#include "RosterIndex.h"
+#include "RosterSort.h"
+#include "RosterTokenizer.h"
+#include "StudentKey.h"
+
 // ==============================
 //  空白
 // ==============================
@@ -18,32 +34,13 @@ static inline void TrimInPlace(std::string &s) {
     s.pop_back();
 }
 
-// ==============================
-//  学籍番号キー抽出
-// ==============================
-struct StuKey {
-  int year = 0; // kの後ろ3桁
-  int num = 0;  // gの後ろ4桁
-  bool valid = false;
-};
-
-static StuKey ParseKey(const std::string &mail) {
-  static const std::regex re(R"(k(\d{3})g(\d{4})@)", std::regex::icase);
-  std::smatch m;
-  StuKey key;
-  if (std::regex_search(mail, m, re) && m.size() >= 3) {
-    key.year = std::stoi(m[1].str());
-    key.num = std::stoi(m[2].str());
-    key.valid = true;
-  }
-  return key;
-}
-
 // ==============================
 //  比較関数：学籍番号 昇順
+//   比較のたびに両方を解析する従来版。並び順の基準（とベンチマークの比較対象）
+//   として残す。実際の並べ替えは SortKeysByStuId を使う
 // ==============================
 static bool LessByStuId(const std::string &a, const std::string &b) {
-  StuKey ka = ParseKey(a), kb = ParseKey(b);
+  StuKey ka = ParseKeyRegex(a), kb = ParseKeyRegex(b);
   if (ka.valid != kb.valid)
     return ka.valid && !kb.valid;
   if (!ka.valid)
@@ -56,7 +53,7 @@ static bool LessByStuId(const std::string &a, const std::string &b) {
 }
 
 // ==============================
-//  ファイル読み込み
+//  ファイル読み込み（1文字ずつ読む従来版。ベンチマークの比較対象）
 //   - 区切り: , / 改行 / 空白 / ;
 // ==============================
 static bool LoadLinks(const std::string &path, std::vector<std::string> &out) {
@@ -88,14 +85,31 @@ static bool LoadLinks(const std::string &path, std::vector<std::string> &out) {
   return !out.empty();
 }
 
+// ==============================
+//  ファイル読み込み（メモリマップ）
+//   - 区切りは LoadLinks と同じ
+//   - トークンは写像を指す string_view（file を閉じるまで有効）
+//   - トークンごとのヒープ確保はしない
+// ==============================
+static bool LoadLinksMapped(const std::string &path, MappedFile &file,
+                            std::vector<std::string_view> &out) {
+  if (!file.Open(path))
+    return false;
+  SplitRoster(file.view(), out);
+  return !out.empty();
+}
+
 // ==============================
 //  表示ユーティリティ
 // ==============================
-static void PrintList(const std::vector<std::string> &v, const char *title) {
+static void PrintList(const std::vector<std::string_view> &v,
+                      const std::vector<std::uint64_t> &sortedKeys,
+                      const char *title) {
   std::cout << "===== " << title << " =====\n";
   int i = 1;
-  for (const auto &s : v) {
-    const auto k = ParseKey(s);
+  for (std::uint64_t pk : sortedKeys) {
+    const auto &s = v[KeyIndex(pk)];
+    const auto k = UnpackKey(pk);
     if (k.valid) {
       std::cout << i++ << ". " << s << "   (k" << k.year << ", g" << k.num
                 << ")\n";
@@ -106,24 +120,304 @@ static void PrintList(const std::vector<std::string> &v, const char *title) {
   std::cout << "\n";
 }
 
+// ==============================
+//  ベンチマーク
+//   使い方: 01_02.exe --bench
+// ==============================
+using BenchClock = std::chrono::steady_clock;
+
+static double ElapsedMs(BenchClock::time_point t0) {
+  return std::chrono::duration<double, std::milli>(BenchClock::now() - t0)
+      .count();
+}
+
+// 実データに似た名簿を n 件作る（約1%はキーなし、大文字混じりもある）
+static std::vector<std::string> MakeSyntheticRoster(size_t n) {
+  std::mt19937 rng(20250101);
+  std::uniform_int_distribution<int> year(20, 25), num(0, 1200), pct(0, 99);
+  std::vector<std::string> v;
+  v.reserve(n);
+  char buf[64];
+  for (size_t i = 0; i < n; ++i) {
+    const int p = pct(rng);
+    if (p == 0) {
+      std::snprintf(buf, sizeof(buf), "guest%05d@example.com", num(rng));
+    } else {
+      std::snprintf(buf, sizeof(buf), "%c%03dg%04d@g.neec.ac.jp",
+                    p < 5 ? 'K' : 'k', year(rng), num(rng));
+    }
+    v.emplace_back(buf);
+  }
+  return v;
+}
+
+// 名簿をファイルに書き出す（区切りは , と改行を混ぜる）
+static bool WriteRosterFile(const std::string &path,
+                            const std::vector<std::string> &roster) {
+  std::ofstream ofs(path, std::ios::binary);
+  for (size_t i = 0; i < roster.size(); ++i)
+    ofs << roster[i] << (i % 16 == 15 ? ",\r\n" : ",");
+  return static_cast<bool>(ofs);
+}
+
+static void RunBenchmarks() {
+  std::cout << std::fixed << std::setprecision(1);
+
+  // 読み込み（1文字ずつ + std::string vs メモリマップ + string_view）
+  {
+    const std::string tmpPath = "roster_bench.tmp";
+    const auto roster = MakeSyntheticRoster(1000000);
+    if (WriteRosterFile(tmpPath, roster)) {
+      auto t0 = BenchClock::now();
+      std::vector<std::string> legacy;
+      LoadLinks(tmpPath, legacy);
+      const double legacyMs = ElapsedMs(t0);
+
+      t0 = BenchClock::now();
+      MappedFile file;
+      std::vector<std::string_view> mapped;
+      LoadLinksMapped(tmpPath, file, mapped);
+      const double mappedMs = ElapsedMs(t0);
+
+      const double mb = static_cast<double>(file.size()) / (1024.0 * 1024.0);
+      const bool same = legacy.size() == mapped.size() &&
+                        std::equal(legacy.begin(), legacy.end(),
+                                   mapped.begin());
+      std::cout << "===== load " << roster.size() << " addresses (" << mb
+                << " MB) =====\n";
+      std::cout << "ifstream::get : " << legacyMs << " ms ("
+                << mb / (legacyMs * 1e-3) << " MB/s)\n";
+      std::cout << "mapped        : " << mappedMs << " ms ("
+                << mb / (mappedMs * 1e-3) << " MB/s)"
+                << (same ? "" : "  [token mismatch]") << "\n\n";
+
+      // 並列解析（分割 + キー解析）のスケーリング
+      auto serialKeys = SortKeysByStuId(mapped);
+      const unsigned cores =
+          std::max(1u, std::thread::hardware_concurrency());
+      std::cout << "===== parallel parse (split + key) =====\n";
+      std::cout << std::left << std::setw(10) << "threads" << std::setw(12)
+                << "ms" << std::setw(12) << "MB/s"
+                << "scaling\n";
+      std::vector<unsigned> counts; // 1, 2, 4, ... と最後に全コア
+      for (unsigned t = 1; t < cores; t *= 2)
+        counts.push_back(t);
+      counts.push_back(cores);
+      double oneThreadMs = 0.0;
+      for (unsigned t : counts) {
+        std::vector<std::string_view> links;
+        std::vector<std::uint64_t> keys;
+        t0 = BenchClock::now();
+        ParseRosterParallel(file.view(), t, links, keys);
+        const double ms = ElapsedMs(t0);
+        if (t == 1)
+          oneThreadMs = ms;
+        SortPackedKeys(keys, links);
+        std::cout << std::left << std::setw(10) << t << std::setw(12) << ms
+                  << std::setw(12) << mb / (ms * 1e-3) << (oneThreadMs / ms)
+                  << "x" << (keys == serialKeys ? "" : "  [order mismatch]")
+                  << "\n";
+      }
+      std::cout << "\n";
+    }
+    std::remove(tmpPath.c_str());
+  }
+
+  // 1件あたりの解析コスト
+  {
+    const auto roster = MakeSyntheticRoster(200000);
+    int sink = 0;
+    auto t0 = BenchClock::now();
+    for (const auto &s : roster)
+      sink += ParseKeyRegex(s).num;
+    const double regexNs = ElapsedMs(t0) * 1e6 / roster.size();
+    t0 = BenchClock::now();
+    for (const auto &s : roster)
+      sink -= ParseKey(s).num;
+    const double scanNs = ElapsedMs(t0) * 1e6 / roster.size();
+    std::cout << "===== parse cost (ns / address) =====\n";
+    std::cout << "std::regex: " << regexNs << "\n";
+    std::cout << "ScanKey   : " << scanNs << "  (" << (regexNs / scanNs)
+              << "x)" << (sink == 0 ? "" : " [mismatch]") << "\n\n";
+  }
+
+  std::cout << "===== sort by student id (ms) =====\n";
+  std::cout << std::left << std::setw(12) << "addresses" << std::setw(18)
+            << "std::sort+regex" << std::setw(16) << "packed radix"
+            << "speedup\n";
+
+  const size_t sizes[] = {10000, 100000, 1000000};
+  for (size_t n : sizes) {
+    const auto roster = MakeSyntheticRoster(n);
+
+    auto t0 = BenchClock::now();
+    const auto keys = SortKeysByStuId(roster);
+    const double radix = ElapsedMs(t0);
+
+    // 比較ごとに正規表現を走らせる従来版は 1M 件だと分単位になるので省く
+    if (n > 100000) {
+      std::cout << std::left << std::setw(12) << n << std::setw(18) << "-"
+                << std::setw(16) << radix << "-\n";
+      continue;
+    }
+    auto legacy = roster;
+    t0 = BenchClock::now();
+    std::sort(legacy.begin(), legacy.end(), LessByStuId);
+    const double baseline = ElapsedMs(t0);
+
+    for (size_t i = 0; i < n; ++i) {
+      if (roster[KeyIndex(keys[i])] != legacy[i]) {
+        std::cout << "[Error] order mismatch at " << i << "\n";
+        break;
+      }
+    }
+    std::cout << std::left << std::setw(12) << n << std::setw(18) << baseline
+              << std::setw(16) << radix << (baseline / radix) << "x\n";
+  }
+}
+
+// ==============================
+//  ScanKey と正規表現版の突き合わせ
+//   使い方: 01_02.exe --verify [件数]
+//   一致しそうで一致しない文字列を多めに混ぜた乱数入力で比べる
+// ==============================
+static bool VerifyScanKey(size_t count) {
+  std::mt19937 rng(7);
+  const char alphabet[] = "kKgG0123456789@@..abz \t\x80\xff";
+  std::uniform_int_distribution<size_t> pickChar(0, sizeof(alphabet) - 2);
+  std::uniform_int_distribution<int> pickLen(0, 80), coin(0, 3);
+  const char *planted[] = {"k024g0001@", "K999G9999@", "k02g0001@",
+                           "k0245g001@", "kk024g0001@@", "k024g00x1@"};
+  std::uniform_int_distribution<size_t> pickPlant(0, 5);
+
+  size_t failures = 0;
+  std::string s;
+  for (size_t i = 0; i < count; ++i) {
+    s.clear();
+    const int len = pickLen(rng);
+    for (int c = 0; c < len; ++c) {
+      if (coin(rng) == 0 && c % 7 == 0)
+        s += planted[pickPlant(rng)];
+      else
+        s += alphabet[pickChar(rng)];
+    }
+    const StuKey a = ParseKeyRegex(s), b = ParseKey(s);
+    if (a.valid != b.valid || a.year != b.year || a.num != b.num) {
+      if (++failures <= 10)
+        std::cout << "[Mismatch] \"" << s << "\"\n";
+    }
+  }
+  std::cout << "verified " << count << " inputs, " << failures
+            << " mismatches\n";
+  return failures == 0;
+}
+
+// コマンドラインの10進の符号なし整数（全体が数字でなければ false）
+static bool ParseU64(const char *text, std::uint64_t &value) {
+  char *end = nullptr;
+  errno = 0;
+  value = std::strtoull(text, &end, 10);
+  return end != text && *end == '\0' && errno != ERANGE && text[0] != '-';
+}
+
 int main(int argc, char *argv[]) {
-  const std::string path = (argc >= 2) ? argv[1] : "PG3_2025_01_02.txt";
+  if (argc >= 2 && std::string(argv[1]) == "--bench") {
+    RunBenchmarks();
+    return 0;
+  }
+  if (argc >= 2 && std::string(argv[1]) == "--verify") {
+    const size_t count = argc >= 3 ? std::stoul(argv[2]) : 200000;
+    return VerifyScanKey(count) ? 0 : 1;
+  }
+
+  // 01_02.exe [オプション] [ファイル]
+  //   --threads N : 並列解析のスレッド数（0 でコア数）
+  //   --external  : メモリに載らない名簿用の外部マージソート
+  //   --mem MB    : 外部ソートの作業メモリ上限（既定 256MB）
+  //   --temp DIR  : 外部ソートの一時ファイル置き場（既定 カレント）
+  //   --index     : 索引ファイル（既定 <ファイル>.idx）に追記分だけ取り込み、
+  //                 重複を除いた表を出す
+  //   --index-file PATH : 索引ファイルの場所
+  const unsigned kMaxThreads = 1024;
+  std::string path = "PG3_2025_01_02.txt";
+  unsigned threads = 1;
+  bool external = false;
+  bool useIndex = false;
+  std::string indexPath;
+  ExternalSortOptions externalOptions;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--threads" && i + 1 < argc) {
+      std::uint64_t value = 0;
+      if (!ParseU64(argv[++i], value) || value > kMaxThreads) {
+        std::cerr << "[Error] --threads は 0〜" << kMaxThreads
+                  << " で指定してください: " << argv[i] << "\n";
+        return 1;
+      }
+      threads = static_cast<unsigned>(value);
+    } else if (arg == "--external") {
+      external = true;
+    } else if (arg == "--index") {
+      useIndex = true;
+    } else if (arg == "--index-file" && i + 1 < argc) {
+      useIndex = true;
+      indexPath = argv[++i];
+    } else if (arg == "--mem" && i + 1 < argc) {
+      std::uint64_t mb = 0;
+      if (!ParseU64(argv[++i], mb) || mb == 0 || mb > (SIZE_MAX >> 20)) {
+        std::cerr << "[Error] --mem は 1〜" << (SIZE_MAX >> 20)
+                  << " (MB) で指定してください: " << argv[i] << "\n";
+        return 1;
+      }
+      externalOptions.memoryBudget = static_cast<size_t>(mb) << 20;
+    } else if (arg == "--temp" && i + 1 < argc) {
+      externalOptions.tempDir = argv[++i];
+    } else {
+      path = arg;
+    }
+  }
+
+  if (useIndex) {
+    std::string error;
+    if (indexPath.empty())
+      indexPath = path + ".idx";
+    if (!UpdateRosterIndex(path, indexPath, stdout, error)) {
+      std::cerr << "[Error] " << error << "\n";
+      return 1;
+    }
+    return 0;
+  }
+
+  if (external) {
+    std::string error;
+    if (!ExternalSortRoster(path, stdout, externalOptions, error)) {
+      std::cerr << "[Error] " << error << "\n";
+      return 1;
+    }
+    return 0;
+  }
 
-  std::vector<std::string> links;
-  if (!LoadLinks(path, links)) {
+  // 分割と学籍番号キーの解析は区間ごとに並列（threads == 1 なら逐次）
+  MappedFile file;
+  std::vector<std::string_view> links;
+  std::vector<std::uint64_t> keys;
+  if (file.Open(path))
+    ParseRosterParallel(file.view(), threads, links, keys);
+  if (links.empty()) {
     std::cerr << "[Error] ファイルを開けないか、データが空です: " << path
               << "\n";
     return 1;
   }
 
-  // 学籍番号で昇順ソート
-  std::sort(links.begin(), links.end(), LessByStuId);
+  // 学籍番号で昇順ソート（詰めたキーを基数ソート）
+  SortPackedKeys(keys, links);
 
   // 最終表（提出用出力）
   std::cout << "No, student-id, email\n";
   int no = 1;
-  for (const auto &s : links) {
-    const auto k = ParseKey(s);
+  for (std::uint64_t pk : keys) {
+    const auto &s = links[KeyIndex(pk)];
+    const auto k = UnpackKey(pk);
     if (k.valid) {
       std::cout << no++ << ", k" << k.year << "g" << k.num << ", " << s << "\n";
     } else {
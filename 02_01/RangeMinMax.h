@@ -0,0 +1,398 @@
+// RangeMinMax.h
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+// SSE2 は x64 なら常に使える。AVX2 は /arch:AVX2（-mavx2）のときだけ使う
+#if defined(_M_X64) || defined(__SSE2__)
+#define MINMAX_SIMD 1
+#include <immintrin.h>
+#endif
+
+// ================================
+// 2つの値を比べて小さい方を返す
+// ================================
+template <typename T> T Min(T a, T b) { return (a < b) ? a : b; }
+
+// 大きい方（同じなら a）
+template <typename T> T Max(T a, T b) { return (a < b) ? b : a; }
+
+// ================================
+//  範囲（span）の最小・最大
+//   Min / Max / MinMax … 値（空の範囲は不可）
+//   ArgMin / ArgMax    … 最初に現れた位置（空なら 0）
+//
+//   float / double / int32_t は SSE2・AVX2 の版、
+//   それ以外の型は operator< だけを使う汎用の版になる（コンパイル時に選ぶ）
+//
+//  NaN の扱い（fmin / fmax と同じ）
+//   - NaN は無視する。NaN 以外の値が1つでもあればその中の最小・最大
+//   - 全部 NaN なら NaN を返す（ArgMin / ArgMax は 0）
+//   - -0.0 と +0.0 は等しいとみなし、値としてどちらが返るかは決めない
+//  どの場合も Min(s) == s[ArgMin(s)]（NaN どうしを除く）
+// ================================
+namespace minmax_generic {
+
+// 最初の NaN でない位置（全部 NaN なら 0）
+template <class T> size_t FirstOrdered(const T *p, size_t n) {
+  if constexpr (std::is_floating_point_v<T>) {
+    for (size_t i = 0; i < n; ++i) {
+      if (!std::isnan(p[i]))
+        return i;
+    }
+  }
+  return 0;
+}
+
+template <bool kMax, class T> size_t ArgExtreme(const T *p, size_t n) {
+  size_t best = FirstOrdered(p, n);
+  for (size_t i = best + 1; i < n; ++i) {
+    if (kMax ? p[best] < p[i] : p[i] < p[best])
+      best = i;
+  }
+  return best;
+}
+
+template <class T> std::pair<T, T> MinMax(const T *p, size_t n) {
+  const size_t first = FirstOrdered(p, n);
+  size_t lo = first, hi = first;
+  for (size_t i = first + 1; i < n; ++i) {
+    if (p[i] < p[lo])
+      lo = i;
+    else if (p[hi] < p[i])
+      hi = i;
+  }
+  return {p[lo], p[hi]};
+}
+
+} // namespace minmax_generic
+
+namespace minmax_simd {
+
+// SIMD 版がある型だけ true
+template <class T> inline constexpr bool kHasOps = false;
+
+// 型ごとの命令の対応表（SIMD が使えるときだけ特殊化する）
+//  Min(x, acc) / Max(x, acc) は比較が偽なら acc を返すので、x が NaN なら
+//  acc が残る（acc は NaN にならない初期値から始める）
+template <class T> struct Ops;
+
+#if defined(MINMAX_SIMD)
+#if defined(__AVX2__)
+template <> struct Ops<float> {
+  using V = __m256;
+  static constexpr size_t kLanes = 8;
+  static V Load(const float *p) { return _mm256_loadu_ps(p); }
+  static V Set1(float x) { return _mm256_set1_ps(x); }
+  static void Store(float *p, V v) { _mm256_storeu_ps(p, v); }
+  static V Min(V x, V acc) { return _mm256_min_ps(x, acc); }
+  static V Max(V x, V acc) { return _mm256_max_ps(x, acc); }
+  static unsigned EqMask(V a, V b) {
+    return static_cast<unsigned>(
+        _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)));
+  }
+};
+
+template <> struct Ops<double> {
+  using V = __m256d;
+  static constexpr size_t kLanes = 4;
+  static V Load(const double *p) { return _mm256_loadu_pd(p); }
+  static V Set1(double x) { return _mm256_set1_pd(x); }
+  static void Store(double *p, V v) { _mm256_storeu_pd(p, v); }
+  static V Min(V x, V acc) { return _mm256_min_pd(x, acc); }
+  static V Max(V x, V acc) { return _mm256_max_pd(x, acc); }
+  static unsigned EqMask(V a, V b) {
+    return static_cast<unsigned>(
+        _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)));
+  }
+};
+
+template <> struct Ops<std::int32_t> {
+  using V = __m256i;
+  static constexpr size_t kLanes = 8;
+  static V Load(const std::int32_t *p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  }
+  static V Set1(std::int32_t x) { return _mm256_set1_epi32(x); }
+  static void Store(std::int32_t *p, V v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+  }
+  static V Min(V x, V acc) { return _mm256_min_epi32(x, acc); }
+  static V Max(V x, V acc) { return _mm256_max_epi32(x, acc); }
+  static unsigned EqMask(V a, V b) {
+    return static_cast<unsigned>(
+        _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))));
+  }
+};
+#else
+template <> struct Ops<float> {
+  using V = __m128;
+  static constexpr size_t kLanes = 4;
+  static V Load(const float *p) { return _mm_loadu_ps(p); }
+  static V Set1(float x) { return _mm_set1_ps(x); }
+  static void Store(float *p, V v) { _mm_storeu_ps(p, v); }
+  static V Min(V x, V acc) { return _mm_min_ps(x, acc); }
+  static V Max(V x, V acc) { return _mm_max_ps(x, acc); }
+  static unsigned EqMask(V a, V b) {
+    return static_cast<unsigned>(_mm_movemask_ps(_mm_cmpeq_ps(a, b)));
+  }
+};
+
+template <> struct Ops<double> {
+  using V = __m128d;
+  static constexpr size_t kLanes = 2;
+  static V Load(const double *p) { return _mm_loadu_pd(p); }
+  static V Set1(double x) { return _mm_set1_pd(x); }
+  static void Store(double *p, V v) { _mm_storeu_pd(p, v); }
+  static V Min(V x, V acc) { return _mm_min_pd(x, acc); }
+  static V Max(V x, V acc) { return _mm_max_pd(x, acc); }
+  static unsigned EqMask(V a, V b) {
+    return static_cast<unsigned>(_mm_movemask_pd(_mm_cmpeq_pd(a, b)));
+  }
+};
+
+// SSE2 には 32bit 整数の min/max が無いので比較とマスクで選ぶ
+template <> struct Ops<std::int32_t> {
+  using V = __m128i;
+  static constexpr size_t kLanes = 4;
+  static V Load(const std::int32_t *p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+  }
+  static V Set1(std::int32_t x) { return _mm_set1_epi32(x); }
+  static void Store(std::int32_t *p, V v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+  }
+  static V Select(V mask, V a, V b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+  }
+  static V Min(V x, V acc) {
+#if defined(__SSE4_1__)
+    return _mm_min_epi32(x, acc);
+#else
+    return Select(_mm_cmplt_epi32(x, acc), x, acc);
+#endif
+  }
+  static V Max(V x, V acc) {
+#if defined(__SSE4_1__)
+    return _mm_max_epi32(x, acc);
+#else
+    return Select(_mm_cmpgt_epi32(x, acc), x, acc);
+#endif
+  }
+  static unsigned EqMask(V a, V b) {
+    return static_cast<unsigned>(
+        _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))));
+  }
+};
+#endif
+
+template <> inline constexpr bool kHasOps<float> = true;
+template <> inline constexpr bool kHasOps<double> = true;
+template <> inline constexpr bool kHasOps<std::int32_t> = true;
+#endif
+
+// 「これより良い値が無ければ残る」初期値（NaN ではない）
+template <bool kMax, class T> constexpr T Identity() {
+  using L = std::numeric_limits<T>;
+  if constexpr (L::has_infinity)
+    return kMax ? -L::infinity() : L::infinity();
+  else
+    return kMax ? L::lowest() : L::max();
+}
+
+// x が acc より良いか（NaN は常に偽）
+template <bool kMax, class T> bool Better(T x, T acc) {
+  return kMax ? acc < x : x < acc;
+}
+
+template <bool kMax, class O> typename O::V Pick(typename O::V x,
+                                                 typename O::V acc) {
+  if constexpr (kMax)
+    return O::Max(x, acc);
+  else
+    return O::Min(x, acc);
+}
+
+// NaN を無視した最小・最大。良い値が無ければ Identity を返す
+//  加算と同じく依存の連鎖を切るため4本のアキュムレータで回す
+template <bool kMax, class T> T Reduce(const T *p, size_t n) {
+  using O = Ops<T>;
+  const size_t L = O::kLanes;
+  const T id = Identity<kMax, T>();
+  typename O::V a0 = O::Set1(id), a1 = a0, a2 = a0, a3 = a0;
+  size_t i = 0;
+  for (; i + 4 * L <= n; i += 4 * L) {
+    a0 = Pick<kMax, O>(O::Load(p + i), a0);
+    a1 = Pick<kMax, O>(O::Load(p + i + L), a1);
+    a2 = Pick<kMax, O>(O::Load(p + i + 2 * L), a2);
+    a3 = Pick<kMax, O>(O::Load(p + i + 3 * L), a3);
+  }
+  for (; i + L <= n; i += L)
+    a0 = Pick<kMax, O>(O::Load(p + i), a0);
+  a0 = Pick<kMax, O>(Pick<kMax, O>(a0, a1), Pick<kMax, O>(a2, a3));
+
+  T lanes[L];
+  O::Store(lanes, a0);
+  T r = id;
+  for (size_t k = 0; k < L; ++k) {
+    if (Better<kMax>(lanes[k], r))
+      r = lanes[k];
+  }
+  for (; i < n; ++i) {
+    if (Better<kMax>(p[i], r))
+      r = p[i];
+  }
+  return r;
+}
+
+// value と等しい最初の位置（無ければ n）
+template <class T> size_t FindFirst(const T *p, size_t n, T value) {
+  using O = Ops<T>;
+  const size_t L = O::kLanes;
+  const typename O::V v = O::Set1(value);
+  size_t i = 0;
+  for (; i + L <= n; i += L) {
+    const unsigned mask = O::EqMask(O::Load(p + i), v);
+    if (mask) {
+      size_t k = 0;
+      while (!(mask >> k & 1u))
+        ++k;
+      return i + k;
+    }
+  }
+  for (; i < n; ++i) {
+    if (p[i] == value)
+      return i;
+  }
+  return n;
+}
+
+template <bool kMax, class T> T Extreme(const T *p, size_t n) {
+  const T r = Reduce<kMax>(p, n);
+  // 初期値のままで、それと等しい要素も無いなら全部 NaN
+  if constexpr (std::is_floating_point_v<T>) {
+    if (r == Identity<kMax, T>() && FindFirst(p, n, r) == n)
+      return p[0];
+  }
+  return r;
+}
+
+// ブロック（L1 に収まる大きさ）ごとの最良値だけを覚えて1回読み、
+// 最後に勝ったブロックの中だけ位置を探す
+template <bool kMax, class T> size_t ArgExtreme(const T *p, size_t n) {
+  const size_t kBlock = 4096;
+  T best = Identity<kMax, T>();
+  size_t bestAt = n;
+  for (size_t b = 0; b < n; b += kBlock) {
+    const T m = Reduce<kMax>(p + b, std::min(kBlock, n - b));
+    if (Better<kMax>(m, best)) {
+      best = m;
+      bestAt = b;
+    }
+  }
+  if (bestAt == n) {
+    // 初期値より良い値が無い: 初期値そのものを探す（全部 NaN なら 0）
+    const size_t i = FindFirst(p, n, best);
+    return i == n ? 0 : i;
+  }
+  return bestAt + FindFirst(p + bestAt, std::min(kBlock, n - bestAt), best);
+}
+
+template <class T> std::pair<T, T> MinMax(const T *p, size_t n) {
+  using O = Ops<T>;
+  const size_t L = O::kLanes;
+  const T idLo = Identity<false, T>();
+  const T idHi = Identity<true, T>();
+  typename O::V lo0 = O::Set1(idLo), lo1 = lo0;
+  typename O::V hi0 = O::Set1(idHi), hi1 = hi0;
+  size_t i = 0;
+  for (; i + 2 * L <= n; i += 2 * L) {
+    const typename O::V x0 = O::Load(p + i);
+    const typename O::V x1 = O::Load(p + i + L);
+    lo0 = O::Min(x0, lo0);
+    hi0 = O::Max(x0, hi0);
+    lo1 = O::Min(x1, lo1);
+    hi1 = O::Max(x1, hi1);
+  }
+  lo0 = O::Min(lo0, lo1);
+  hi0 = O::Max(hi0, hi1);
+
+  T los[L], his[L];
+  O::Store(los, lo0);
+  O::Store(his, hi0);
+  T lo = idLo, hi = idHi;
+  for (size_t k = 0; k < L; ++k) {
+    if (los[k] < lo)
+      lo = los[k];
+    if (hi < his[k])
+      hi = his[k];
+  }
+  for (; i < n; ++i) {
+    if (p[i] < lo)
+      lo = p[i];
+    if (hi < p[i])
+      hi = p[i];
+  }
+  // NaN 以外が1つでもあれば lo <= hi になる
+  if constexpr (std::is_floating_point_v<T>) {
+    if (hi < lo)
+      return {p[0], p[0]};
+  }
+  return {lo, hi};
+}
+
+} // namespace minmax_simd
+
+template <class T, std::size_t E> std::remove_cv_t<T> Min(std::span<T, E> s) {
+  using U = std::remove_cv_t<T>;
+  assert(!s.empty());
+  if constexpr (minmax_simd::kHasOps<U>)
+    return minmax_simd::Extreme<false>(s.data(), s.size());
+  else
+    return s[minmax_generic::ArgExtreme<false>(s.data(), s.size())];
+}
+
+template <class T, std::size_t E> std::remove_cv_t<T> Max(std::span<T, E> s) {
+  using U = std::remove_cv_t<T>;
+  assert(!s.empty());
+  if constexpr (minmax_simd::kHasOps<U>)
+    return minmax_simd::Extreme<true>(s.data(), s.size());
+  else
+    return s[minmax_generic::ArgExtreme<true>(s.data(), s.size())];
+}
+
+// {最小, 最大} を1回の走査で
+template <class T, std::size_t E>
+std::pair<std::remove_cv_t<T>, std::remove_cv_t<T>>
+MinMax(std::span<T, E> s) {
+  using U = std::remove_cv_t<T>;
+  assert(!s.empty());
+  if constexpr (minmax_simd::kHasOps<U>)
+    return minmax_simd::MinMax<U>(s.data(), s.size());
+  else
+    return minmax_generic::MinMax<U>(s.data(), s.size());
+}
+
+template <class T, std::size_t E> size_t ArgMin(std::span<T, E> s) {
+  using U = std::remove_cv_t<T>;
+  if constexpr (minmax_simd::kHasOps<U>)
+    return minmax_simd::ArgExtreme<false, U>(s.data(), s.size());
+  else
+    return minmax_generic::ArgExtreme<false, U>(s.data(), s.size());
+}
+
+template <class T, std::size_t E> size_t ArgMax(std::span<T, E> s) {
+  using U = std::remove_cv_t<T>;
+  if constexpr (minmax_simd::kHasOps<U>)
+    return minmax_simd::ArgExtreme<true, U>(s.data(), s.size());
+  else
+    return minmax_generic::ArgExtreme<true, U>(s.data(), s.size());
+}
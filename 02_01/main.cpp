@@ -1,12 +1,133 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "RangeMinMax.h"
 using namespace std;
 
-// ================================
-// 2つの値を比べて小さい方を返す
-// ================================
-template <typename T> T Min(T a, T b) { return (a < b) ? a : b; }
+// ==============================
+//  範囲版の確認とベンチマーク
+//   使い方: 02_01.exe --bench
+//   L1 に収まる大きさから DRAM まで、std::min_element と比べる
+// ==============================
+using BenchClock = chrono::steady_clock;
+
+// 結果はその型のまま書き込む（負の float を size_t に直すのは未定義動作）
+template <class T> static volatile T g_benchSink;
+
+// NaN の扱いが決めたとおりか
+static bool CheckNaN() {
+  const float nan = numeric_limits<float>::quiet_NaN();
+  const float inf = numeric_limits<float>::infinity();
+  bool ok = true;
+
+  // 先頭・途中・末尾の NaN は無視される（SIMD の幅をまたぐ長さで）
+  vector<float> v(37);
+  for (size_t i = 0; i < v.size(); ++i)
+    v[i] = static_cast<float>(i) + 1.0f;
+  v[0] = v[5] = v[36] = nan;
+  v[20] = -3.0f;
+  ok = ok && Min(span(v)) == -3.0f && ArgMin(span(v)) == 20;
+  ok = ok && Max(span(v)) == 36.0f && ArgMax(span(v)) == 35;
+  ok = ok && MinMax(span(v)) == make_pair(-3.0f, 36.0f);
+
+  // 全部 NaN
+  vector<float> all(19, nan);
+  ok = ok && isnan(Min(span(all))) && isnan(Max(span(all)));
+  ok = ok && isnan(MinMax(span(all)).first) && ArgMin(span(all)) == 0;
+
+  // 本物の無限大は初期値と区別される
+  vector<float> infs(40, nan);
+  infs[33] = inf;
+  ok = ok && Min(span(infs)) == inf && ArgMin(span(infs)) == 33;
+
+  // 汎用版（long double）も同じ決まり
+  vector<long double> ld = {nan, 2.0L, nan, -1.0L, -1.0L};
+  ok = ok && Min(span(ld)) == -1.0L && ArgMin(span(ld)) == 3;
+  return ok;
+}
+
+template <class T> static vector<T> MakeData(size_t n, mt19937 &rng) {
+  vector<T> v(n);
+  if constexpr (is_floating_point_v<T>) {
+    uniform_real_distribution<T> dist(-1000, 1000);
+    for (auto &x : v)
+      x = dist(rng);
+  } else {
+    uniform_int_distribution<T> dist(-1000000, 1000000);
+    for (auto &x : v)
+      x = dist(rng);
+  }
+  return v;
+}
+
+// 1回あたりの時間（ns）。合計 256MB ほど読むまで繰り返す
+template <class F> static double TimePerCall(size_t bytes, F f) {
+  const size_t reps = max<size_t>(1, (size_t{256} << 20) / bytes);
+  const auto t0 = BenchClock::now();
+  for (size_t r = 0; r < reps; ++r)
+    g_benchSink<decltype(f())> = f();
+  return chrono::duration<double, nano>(BenchClock::now() - t0).count() /
+         static_cast<double>(reps);
+}
+
+template <class T> static void BenchType(const char *name) {
+  cout << "===== " << name << " (GB/s) =====\n";
+  cout << left << setw(12) << "elements" << setw(12) << "min_element"
+       << setw(12) << "ArgMin" << setw(12) << "Min" << setw(12) << "MinMax"
+       << "speedup\n";
+
+  mt19937 rng(12345);
+  // 16KB（L1）/ 256KB（L2）/ 4MB（L3）/ 256MB（DRAM）
+  const size_t bytesList[] = {size_t{16} << 10, size_t{256} << 10,
+                              size_t{4} << 20, size_t{256} << 20};
+  for (size_t bytes : bytesList) {
+    const size_t n = bytes / sizeof(T);
+    const vector<T> v = MakeData<T>(n, rng);
+    const span<const T> s(v);
+
+    const double stdNs = TimePerCall(bytes, [&] {
+      return static_cast<size_t>(min_element(v.begin(), v.end()) -
+                                 v.begin());
+    });
+    const double argNs = TimePerCall(bytes, [&] { return ArgMin(s); });
+    const double minNs = TimePerCall(bytes, [&] { return Min(s); });
+    const double mmNs = TimePerCall(bytes, [&] { return MinMax(s).second; });
+
+    const size_t expect =
+        static_cast<size_t>(min_element(v.begin(), v.end()) - v.begin());
+    const auto gbps = [&](double ns) { return bytes / ns; };
+    cout << left << setw(12) << n << setw(12) << gbps(stdNs) << setw(12)
+         << gbps(argNs) << setw(12) << gbps(minNs) << setw(12) << gbps(mmNs)
+         << (stdNs / argNs) << "x"
+         << (ArgMin(s) == expect && Min(s) == v[expect] ? "" : "  [mismatch]")
+         << "\n";
+  }
+  cout << "\n";
+}
+
+static void RunBenchmarks() {
+  cout << fixed << setprecision(2);
+  cout << "NaN rules: " << (CheckNaN() ? "ok" : "[Error] mismatch") << "\n\n";
+  BenchType<float>("float");
+  BenchType<int32_t>("int32");
+  BenchType<double>("double");
+}
+
+int main(int argc, char *argv[]) {
+  if (argc >= 2 && string(argv[1]) == "--bench") {
+    RunBenchmarks();
+    return 0;
+  }
 
-int main() {
   // int型の例
   int i1 = 10, i2 = 20;
   cout << "Min(int): " << Min(i1, i2) << endl;
@@ -0,0 +1,186 @@
+// WageEngine.h
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ==============================
+//  再帰的な賃金体系の閉じた式
+//   w(1) = 100, w(h) = 2 w(h-1) - 50
+//   50 を引くと w(h) - 50 = 2 (w(h-1) - 50) なので等比数列になり
+//     w(h) = 50 * 2^(h-1) + 50
+//     T(n) = Σ w(h) = 50 (2^n - 1) + 50 n
+//   どちらも O(1)。0 時間以下の合計は 0（RecursiveTotal と同じ）
+// ==============================
+namespace wage {
+const double kBase = 50.0; // 漸化式の不動点（= 2^(h-1) の係数）
+// 64bit 整数で合計が正確に表せる最大の時間数（50 * 2^58 < 2^64）
+const int kMaxExactHours = 58;
+} // namespace wage
+
+// h 時間目の時給（double、h >= 1）
+inline double WageAt(int hour) {
+  return std::ldexp(wage::kBase, hour - 1) + wage::kBase;
+}
+
+// n 時間の合計（double）。大きな n では丸め、さらに大きいと inf になる
+inline double WageTotal(int hours) {
+  if (hours <= 0)
+    return 0.0;
+  return wage::kBase * (std::ldexp(1.0, hours) - 1.0) + wage::kBase * hours;
+}
+
+// n 時間の合計（整数で正確に）。64bit に収まらなければ false
+inline bool WageTotalExact(int hours, std::uint64_t &total) {
+  if (hours <= 0) {
+    total = 0;
+    return true;
+  }
+  if (hours > wage::kMaxExactHours)
+    return false;
+  const std::uint64_t n = static_cast<std::uint64_t>(hours);
+  total = 50 * (std::uint64_t{1} << n) + 50 * (n - 1);
+  return true;
+}
+
+// ==============================
+//  長いシフト用の多倍長整数（必要な演算だけ）
+//   32bit の桁を下位から並べる
+// ==============================
+class BigUint {
+public:
+  static BigUint PowerOfTwo(unsigned n) {
+    BigUint r;
+    r.m_limbs.assign(n / 32 + 1, 0);
+    r.m_limbs.back() = std::uint32_t{1} << (n % 32);
+    return r;
+  }
+
+  void MulSmall(std::uint32_t m) {
+    std::uint64_t carry = 0;
+    for (auto &limb : m_limbs) {
+      const std::uint64_t x = std::uint64_t{limb} * m + carry;
+      limb = static_cast<std::uint32_t>(x);
+      carry = x >> 32;
+    }
+    if (carry)
+      m_limbs.push_back(static_cast<std::uint32_t>(carry));
+  }
+
+  void AddSmall(std::uint64_t v) {
+    for (size_t i = 0; v != 0; ++i) {
+      if (i == m_limbs.size())
+        m_limbs.push_back(0);
+      const std::uint64_t x = std::uint64_t{m_limbs[i]} + (v & 0xFFFFFFFFu);
+      m_limbs[i] = static_cast<std::uint32_t>(x);
+      v = (v >> 32) + (x >> 32);
+    }
+  }
+
+  // 10進の文字列（桁数を L として O(L^2)）
+  std::string ToString() const {
+    std::vector<std::uint32_t> limbs = m_limbs;
+    std::vector<std::uint32_t> chunks; // 下位から 10^9 ごと
+    while (!limbs.empty()) {
+      std::uint64_t rem = 0;
+      for (size_t i = limbs.size(); i-- > 0;) {
+        const std::uint64_t x = (rem << 32) | limbs[i];
+        limbs[i] = static_cast<std::uint32_t>(x / 1000000000u);
+        rem = x % 1000000000u;
+      }
+      chunks.push_back(static_cast<std::uint32_t>(rem));
+      while (!limbs.empty() && limbs.back() == 0)
+        limbs.pop_back();
+    }
+    if (chunks.empty())
+      return "0";
+    std::string s = std::to_string(chunks.back());
+    for (size_t i = chunks.size() - 1; i-- > 0;) {
+      const std::string part = std::to_string(chunks[i]);
+      s.append(9 - part.size(), '0');
+      s += part;
+    }
+    return s;
+  }
+
+private:
+  std::vector<std::uint32_t> m_limbs;
+};
+
+// n 時間の合計を10進の文字列で（どんな n でも正確）
+inline std::string WageTotalDecimal(int hours) {
+  if (hours <= 0)
+    return "0";
+  // 50 * 2^n + 50 (n - 1)
+  BigUint total = BigUint::PowerOfTwo(static_cast<unsigned>(hours));
+  total.MulSmall(50);
+  total.AddSmall(50 * (static_cast<std::uint64_t>(hours) - 1));
+  return total.ToString();
+}
+
+// ==============================
+//  まとめて比較する API
+//   (社員, 時間数) の記録ごとに、再帰的な賃金体系の合計と
+//   一般的な賃金体系（時給 normalWage）の合計を比べる。
+//   1件 O(1) なので記録を threads 個に等分して並べるだけ
+// ==============================
+struct WageRecord {
+  std::uint32_t employee;
+  int hours;
+};
+
+struct WageComparison {
+  std::uint32_t employee;
+  bool exact;                   // recursiveTotal が正確か（64bit に収まった）
+  std::uint64_t recursiveTotal; // 収まらなければ UINT64_MAX
+  double normalTotal;
+  double difference; // 再帰 - 一般（正なら再帰的な賃金体系が多い）
+};
+
+inline WageComparison CompareWage(const WageRecord &r, double normalWage) {
+  WageComparison c;
+  c.employee = r.employee;
+  c.normalTotal = normalWage * std::max(r.hours, 0);
+  c.exact = WageTotalExact(r.hours, c.recursiveTotal);
+  if (c.exact) {
+    c.difference = static_cast<double>(c.recursiveTotal) - c.normalTotal;
+  } else {
+    c.recursiveTotal = UINT64_MAX;
+    c.difference = WageTotal(r.hours) - c.normalTotal;
+  }
+  return c;
+}
+
+// threads = 0 ならコア数。結果は records と同じ順
+inline std::vector<WageComparison>
+CompareWages(const std::vector<WageRecord> &records, double normalWage,
+             unsigned threads = 0) {
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  // 1スレッドあたり最低 64K 件は任せる（少ない件数でスレッドを立てすぎない）
+  const size_t kMinChunk = 64 * 1024;
+  const size_t maxThreads = std::max<size_t>(1, records.size() / kMinChunk);
+  threads = static_cast<unsigned>(std::min<size_t>(threads, maxThreads));
+
+  std::vector<WageComparison> out(records.size());
+  const auto work = [&](unsigned t) {
+    const size_t begin = records.size() * t / threads;
+    const size_t end = records.size() * (t + 1) / threads;
+    for (size_t i = begin; i < end; ++i)
+      out[i] = CompareWage(records[i], normalWage);
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  for (unsigned t = 1; t < threads; ++t)
+    pool.emplace_back(work, t);
+  work(0);
+  for (auto &th : pool)
+    th.join();
+  return out;
+}
@@ -0,0 +1,333 @@
+// DiceSim.h
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// ==============================
+//  乱数
+//   xoshiro256++（周期 2^256 - 1、1回の生成は加算・シフト・xor だけ）。
+//   種は SplitMix64 で4語に広げる。同じ (seed, stream) なら同じ列になる
+//   Jump() は 2^128 回分進める（重ならない列を作るのに使う）
+// ==============================
+inline std::uint64_t SplitMix64(std::uint64_t &state) {
+  std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+inline std::uint64_t Rotl64(std::uint64_t x, int k) {
+  return (x << k) | (x >> (64 - k));
+}
+
+class Xoshiro256pp {
+public:
+  // stream ごとに別の列（種と stream を混ぜて SplitMix64 に通す）
+  explicit Xoshiro256pp(std::uint64_t seed, std::uint64_t stream = 0) {
+    std::uint64_t sm = seed;
+    std::uint64_t mixed = SplitMix64(sm) ^ stream;
+    for (auto &word : m_s)
+      word = SplitMix64(mixed);
+  }
+
+  std::uint64_t Next() {
+    const std::uint64_t result = Rotl64(m_s[0] + m_s[3], 23) + m_s[0];
+    const std::uint64_t t = m_s[1] << 17;
+    m_s[2] ^= m_s[0];
+    m_s[3] ^= m_s[1];
+    m_s[1] ^= m_s[2];
+    m_s[0] ^= m_s[3];
+    m_s[2] ^= t;
+    m_s[3] = Rotl64(m_s[3], 45);
+    return result;
+  }
+
+  void Jump() {
+    static const std::uint64_t kJump[] = {
+        0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull,
+        0x39ABDC4529B1661Cull};
+    std::uint64_t s[4] = {};
+    for (std::uint64_t jump : kJump) {
+      for (int b = 0; b < 64; ++b) {
+        if (jump & (std::uint64_t{1} << b)) {
+          for (int i = 0; i < 4; ++i)
+            s[i] ^= m_s[i];
+        }
+        Next();
+      }
+    }
+    for (int i = 0; i < 4; ++i)
+      m_s[i] = s[i];
+  }
+
+  // [0, range) の一様な整数（偏りなし）
+  std::uint32_t Below(std::uint32_t range);
+
+  const std::uint64_t *state() const { return m_s; }
+
+private:
+  std::uint64_t m_s[4];
+};
+
+// ==============================
+//  [0, range) への偏りのない写像（Lemire の方法）
+//   32bit の乱数 x に range を掛けた上位 32bit が答え。下位 32bit が
+//   2^32 mod range 未満のときだけ偏るので引き直す（range = 6 なら 4 / 2^32）
+//   「% range」と違って除算はほぼ通らない
+// ==============================
+template <class Next32>
+std::uint32_t BoundedRandom(std::uint32_t x, std::uint32_t range,
+                            Next32 &&next32) {
+  std::uint64_t m = std::uint64_t{x} * range;
+  std::uint32_t low = static_cast<std::uint32_t>(m);
+  if (low < range) {
+    const std::uint32_t threshold = (0u - range) % range;
+    while (low < threshold) {
+      m = std::uint64_t{next32()} * range;
+      low = static_cast<std::uint32_t>(m);
+    }
+  }
+  return static_cast<std::uint32_t>(m >> 32);
+}
+
+inline std::uint32_t Xoshiro256pp::Below(std::uint32_t range) {
+  const auto next32 = [this] {
+    return static_cast<std::uint32_t>(Next() >> 32);
+  };
+  return BoundedRandom(next32(), range, next32);
+}
+
+// ==============================
+//  4本の xoshiro256++ を並べてまとめて回す
+//   レーン k は元の列を k 回 Jump したもの（互いに重ならない）。
+//   AVX2 なら 256bit で4本同時、そうでなければレーンごとのループ
+//   （コンパイラが SSE2 でベクトル化できる形にしてある）
+// ==============================
+class Xoshiro256ppX4 {
+public:
+  static constexpr int kLanes = 4;
+
+  explicit Xoshiro256ppX4(Xoshiro256pp base) {
+    for (int lane = 0; lane < kLanes; ++lane) {
+      for (int w = 0; w < 4; ++w)
+        m_s[w][lane] = base.state()[w];
+      base.Jump();
+    }
+  }
+
+  void Next(std::uint64_t out[kLanes]) {
+#if defined(__AVX2__)
+    const auto load = [this](int w) {
+      return _mm256_load_si256(reinterpret_cast<const __m256i *>(m_s[w]));
+    };
+    const auto rotl = [](__m256i x, int k) {
+      return _mm256_or_si256(_mm256_slli_epi64(x, k),
+                             _mm256_srli_epi64(x, 64 - k));
+    };
+    __m256i s0 = load(0), s1 = load(1), s2 = load(2), s3 = load(3);
+    const __m256i result =
+        _mm256_add_epi64(rotl(_mm256_add_epi64(s0, s3), 23), s0);
+    const __m256i t = _mm256_slli_epi64(s1, 17);
+    s2 = _mm256_xor_si256(s2, s0);
+    s3 = _mm256_xor_si256(s3, s1);
+    s1 = _mm256_xor_si256(s1, s2);
+    s0 = _mm256_xor_si256(s0, s3);
+    s2 = _mm256_xor_si256(s2, t);
+    s3 = rotl(s3, 45);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(m_s[0]), s0);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(m_s[1]), s1);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(m_s[2]), s2);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(m_s[3]), s3);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), result);
+#else
+    for (int i = 0; i < kLanes; ++i) {
+      out[i] = Rotl64(m_s[0][i] + m_s[3][i], 23) + m_s[0][i];
+      const std::uint64_t t = m_s[1][i] << 17;
+      m_s[2][i] ^= m_s[0][i];
+      m_s[3][i] ^= m_s[1][i];
+      m_s[1][i] ^= m_s[2][i];
+      m_s[0][i] ^= m_s[3][i];
+      m_s[2][i] ^= t;
+      m_s[3][i] = Rotl64(m_s[3][i], 45);
+    }
+#endif
+  }
+
+private:
+  alignas(32) std::uint64_t m_s[4][kLanes]; // [状態の語][レーン]
+};
+
+// ==============================
+//  丁半の Monte Carlo
+//   1個のサイコロを振り、予想（半=奇数 / 丁=偶数）が当たった割合を
+//   いくつかの予想の仕方について同じ出目の列で数える。
+//   - 出目は 64bit 乱数の上下 32bit から1つずつ（BoundedRandom）
+//   - 回数を kBlockRounds ごとのブロックに分け、ブロック b は
+//     Xoshiro256pp(seed, b) から作る。スレッドは空いたブロックを取るだけ
+//     なので、結果は seed と回数だけで決まる（スレッド数によらない）
+//   - 「前回どおり / 前回の逆」はブロックをまたいで続く。ブロックは最初と
+//     最後の出目（BlockEnds）を返し、各ブロックの最初の1回は Simulate が
+//     前のブロックの最後とつないで数える。全体の最初の1回だけ直前を半とみなす
+//   - 「交互」は通しの回数の偶奇で決まる（kBlockRounds が偶数なので
+//     ブロック内の偶奇と同じ）
+// ==============================
+namespace dice_sim {
+
+enum Strategy {
+  kAlwaysOdd,    // いつも半
+  kAlwaysEven,   // いつも丁
+  kAlternate,    // 半・丁を交互
+  kFollowLast,   // 前回の出目どおり
+  kOppositeLast, // 前回の出目の逆
+  kCoinFlip,     // 毎回コイン投げ
+  kStrategyCount
+};
+
+inline const char *StrategyName(int s) {
+  static const char *const kNames[kStrategyCount] = {
+      "always odd (han)", "always even (cho)", "alternate",
+      "follow last",      "opposite last",     "coin flip"};
+  return kNames[s];
+}
+
+const std::uint64_t kBlockRounds = std::uint64_t{1} << 22;
+static_assert(kBlockRounds % 2 == 0, "交互の予想はブロック内の偶奇で数える");
+
+// 指定できるスレッド数の上限
+const unsigned kMaxThreads = 1024;
+
+struct Result {
+  std::uint64_t rounds = 0;
+  std::uint64_t wins[kStrategyCount] = {};
+  std::uint64_t faces[6] = {}; // 出目 1..6 の回数
+
+  void Add(const Result &other) {
+    rounds += other.rounds;
+    for (int s = 0; s < kStrategyCount; ++s)
+      wins[s] += other.wins[s];
+    for (int f = 0; f < 6; ++f)
+      faces[f] += other.faces[f];
+  }
+};
+
+// ブロックの最初と最後の回が半だったか（1 なら半）
+struct BlockEnds {
+  std::uint8_t firstOdd = 0;
+  std::uint8_t lastOdd = 0;
+};
+
+// ブロック b の rounds 回（1 以上）
+//  「前回どおり」の最初の1回は数えずに ends を返す（Simulate がつなぐ）
+inline Result SimulateBlock(std::uint64_t seed, std::uint64_t block,
+                            std::uint64_t rounds, BlockEnds &ends) {
+  Xoshiro256pp base(seed, block);
+  Xoshiro256ppX4 dice(base);
+  for (int i = 0; i < Xoshiro256ppX4::kLanes; ++i)
+    base.Jump();
+  Xoshiro256pp &extra = base; // コイン投げと引き直し用（どのレーンとも別）
+  const auto next32 = [&extra] {
+    return static_cast<std::uint32_t>(extra.Next() >> 32);
+  };
+
+  // 「半の回数」などの数え方をまとめ、残りは引き算で出す
+  std::uint64_t odd = 0, alternate = 0, follow = 0, coin = 0;
+  std::uint64_t faces[6] = {};
+  std::uint32_t prevOdd = 1;
+  std::uint64_t coinBits = 0;
+
+  std::uint64_t r[Xoshiro256ppX4::kLanes];
+  const int kPerBatch = Xoshiro256ppX4::kLanes * 2;
+  for (std::uint64_t i = 0; i < rounds;) {
+    dice.Next(r);
+    const int n = static_cast<int>(
+        std::min<std::uint64_t>(kPerBatch, rounds - i));
+    for (int k = 0; k < n; ++k, ++i) {
+      if ((i & 63) == 0)
+        coinBits = extra.Next();
+      const std::uint32_t x =
+          static_cast<std::uint32_t>(r[k >> 1] >> ((k & 1) * 32));
+      const std::uint32_t face = BoundedRandom(x, 6, next32); // 0..5
+      const std::uint32_t isOdd = (face & 1) ^ 1; // 出目 face+1 が奇数
+      if (i == 0)
+        ends.firstOdd = static_cast<std::uint8_t>(isOdd);
+      ++faces[face];
+      odd += isOdd;
+      alternate += isOdd == static_cast<std::uint32_t>(i & 1);
+      follow += isOdd == prevOdd;
+      coin += isOdd == ((coinBits >> (i & 63)) & 1);
+      prevOdd = isOdd;
+    }
+  }
+
+  // 最初の1回は prevOdd = 1 と比べてあるので外す
+  ends.lastOdd = static_cast<std::uint8_t>(prevOdd);
+  follow -= ends.firstOdd == 1;
+
+  Result result;
+  result.rounds = rounds;
+  result.wins[kAlwaysOdd] = odd;
+  result.wins[kAlwaysEven] = rounds - odd;
+  result.wins[kAlternate] = alternate;
+  result.wins[kFollowLast] = follow;
+  result.wins[kOppositeLast] = rounds - 1 - follow; // 最初の1回を除く
+  result.wins[kCoinFlip] = coin;
+  for (int f = 0; f < 6; ++f)
+    result.faces[f] = faces[f];
+  return result;
+}
+
+// rounds 回を threads 本（0 ならコア数、kMaxThreads まで）で
+inline Result Simulate(std::uint64_t rounds, std::uint64_t seed,
+                       unsigned threads = 0) {
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  const std::uint64_t blocks = (rounds + kBlockRounds - 1) / kBlockRounds;
+  threads = static_cast<unsigned>(std::min<std::uint64_t>(
+      std::min(threads, kMaxThreads), std::max<std::uint64_t>(blocks, 1)));
+
+  std::atomic<std::uint64_t> nextBlock{0};
+  std::vector<Result> partial(threads);
+  std::vector<BlockEnds> ends(blocks);
+  const auto work = [&](unsigned t) {
+    for (;;) {
+      const std::uint64_t b = nextBlock.fetch_add(1);
+      if (b >= blocks)
+        break;
+      const std::uint64_t n =
+          std::min(kBlockRounds, rounds - b * kBlockRounds);
+      partial[t].Add(SimulateBlock(seed, b, n, ends[b]));
+    }
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  for (unsigned t = 1; t < threads; ++t)
+    pool.emplace_back(work, t);
+  work(0);
+  for (auto &th : pool)
+    th.join();
+
+  Result total;
+  for (const auto &p : partial)
+    total.Add(p);
+  // 各ブロックの最初の1回を、前のブロックの最後（全体の最初は半）とつなぐ
+  std::uint8_t prevOdd = 1;
+  for (const BlockEnds &e : ends) {
+    const bool same = e.firstOdd == prevOdd;
+    total.wins[kFollowLast] += same;
+    total.wins[kOppositeLast] += !same;
+    prevOdd = e.lastOdd;
+  }
+  return total;
+}
+
+} // namespace dice_sim
@@ -0,0 +1,339 @@
+// TimerWheel.h
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// ==============================
+//  階層タイミングホイール
+//   256 スロット × 4 段（1段 8bit、合計 2^32 tick）と、それより先の予約用の
+//   溢れリスト。予約の満了 tick e と現在 tick の「最初に違う 8bit の段」に
+//   入れておき、その段の下位がすべて 0 になる tick で1つ下の段へ入れ直す。
+//   - 予約・取り消し … O(1)（双方向リストへの挿入・削除）
+//   - 1 tick 進める  … 段の繰り上がりがあるときだけ1スロット分の入れ直し
+//   - 進める途中で発火も入れ直しも無い tick は飛ばす（NextEventTick）
+//  ノードは配列にまとめて置き、空きは単方向リストで使い回す
+//  スレッドは扱わない（TimerService が排他してから呼ぶ）
+// ==============================
+
+// 予約の識別子（添字 + 世代。使い回されたノードの古い ID は無効になる）
+using TimerId = std::uint64_t;
+const TimerId kNoTimer = 0;
+
+template <class Callback> class BasicTimerWheel {
+public:
+  static constexpr int kLevelBits = 8;
+  static constexpr std::uint32_t kSlots = 1u << kLevelBits;
+  static constexpr int kLevels = 4;
+  static constexpr std::uint64_t kNever = ~std::uint64_t{0};
+
+  explicit BasicTimerWheel(std::uint64_t now = 0) : m_now(now) {
+    m_heads.assign(kLevels * kSlots + 1, kNil);
+  }
+
+  // 最後に処理した tick
+  std::uint64_t now() const { return m_now; }
+  size_t size() const { return m_count; }
+  bool empty() const { return m_count == 0; }
+
+  // 満了 tick expiry に fn を予約する（処理済みの tick なら次の tick）
+  TimerId Schedule(std::uint64_t expiry, Callback fn) {
+    std::uint32_t i;
+    if (m_free != kNil) {
+      i = m_free;
+      m_free = m_nodes[i].next;
+    } else {
+      i = static_cast<std::uint32_t>(m_nodes.size());
+      m_nodes.emplace_back();
+    }
+    Node &n = m_nodes[i];
+    n.fn = std::move(fn);
+    n.expiry = expiry > m_now ? expiry : m_now + 1;
+    n.active = true;
+    Link(i);
+    ++m_count;
+    return (static_cast<TimerId>(n.generation) << 32) | (i + 1u);
+  }
+
+  // まだ発火していなければ取り消して true
+  bool Cancel(TimerId id) {
+    const std::uint32_t low = static_cast<std::uint32_t>(id);
+    if (low == 0 || low > m_nodes.size())
+      return false;
+    const std::uint32_t i = low - 1;
+    Node &n = m_nodes[i];
+    if (!n.active || n.generation != static_cast<std::uint32_t>(id >> 32))
+      return false;
+    Unlink(i);
+    Release(i);
+    --m_count;
+    return true;
+  }
+
+  // 次に発火か入れ直しがある tick（空なら kNever）
+  //   段ごとに今の位置より先の使われているスロットを探す。下の段ほど早いので
+  //   最初に見つかった段で決まる。どの段も空なら溢れリストの入れ直し
+  std::uint64_t NextEventTick() const {
+    if (m_count == 0)
+      return kNever;
+    for (int level = 0; level < kLevels; ++level) {
+      const int shift = level * kLevelBits;
+      const std::uint32_t current =
+          static_cast<std::uint32_t>((m_now >> shift) & (kSlots - 1));
+      const int upper = shift + kLevelBits;
+      const std::uint64_t base = (m_now >> upper) << upper;
+      for (std::uint32_t j = current + 1; j < kSlots; ++j) {
+        if (m_heads[level * kSlots + j] != kNil)
+          return base + (std::uint64_t{j} << shift);
+      }
+    }
+    return ((m_now >> (kLevels * kLevelBits)) + 1) << (kLevels * kLevelBits);
+  }
+
+  // tick to まで進め、満了した予約を fire(Callback&&) に渡す（満了順）
+  template <class Fire> void Advance(std::uint64_t to, Fire &&fire) {
+    while (m_now < to) {
+      // その間の tick では何も起きないので一気に進めてよい
+      const std::uint64_t event = NextEventTick();
+      if (event > to) {
+        m_now = to;
+        break;
+      }
+      m_now = event;
+      Cascade();
+      std::uint32_t i = Detach(SlotOf(0, m_now));
+      while (i != kNil) {
+        const std::uint32_t next = m_nodes[i].next;
+        Callback fn = std::move(m_nodes[i].fn);
+        Release(i);
+        --m_count;
+        fire(std::move(fn));
+        i = next;
+      }
+    }
+  }
+
+private:
+  static constexpr std::uint32_t kNil = 0xFFFFFFFFu;
+  static constexpr std::uint32_t kOverflow = kLevels * kSlots;
+
+  struct Node {
+    Callback fn{};
+    std::uint64_t expiry = 0;
+    std::uint32_t prev = kNil;
+    std::uint32_t next = kNil;
+    std::uint32_t slot = 0;       // m_heads の添字
+    std::uint32_t generation = 1; // ID が 0（kNoTimer）にならないよう 1 から
+    bool active = false;
+  };
+
+  static std::uint32_t SlotOf(int level, std::uint64_t tick) {
+    return static_cast<std::uint32_t>(level) * kSlots +
+           static_cast<std::uint32_t>((tick >> (level * kLevelBits)) &
+                                      (kSlots - 1));
+  }
+
+  // 満了 tick と現在 tick が最初に違う段のスロットへ
+  void Link(std::uint32_t i) {
+    Node &n = m_nodes[i];
+    const std::uint64_t diff = n.expiry ^ m_now;
+    std::uint32_t slot = kOverflow;
+    for (int level = 0; level < kLevels; ++level) {
+      if ((diff >> ((level + 1) * kLevelBits)) == 0) {
+        slot = SlotOf(level, n.expiry);
+        break;
+      }
+    }
+    n.slot = slot;
+    n.prev = kNil;
+    n.next = m_heads[slot];
+    if (n.next != kNil)
+      m_nodes[n.next].prev = i;
+    m_heads[slot] = i;
+  }
+
+  void Unlink(std::uint32_t i) {
+    Node &n = m_nodes[i];
+    if (n.prev != kNil)
+      m_nodes[n.prev].next = n.next;
+    else
+      m_heads[n.slot] = n.next;
+    if (n.next != kNil)
+      m_nodes[n.next].prev = n.prev;
+  }
+
+  std::uint32_t Detach(std::uint32_t slot) {
+    const std::uint32_t head = m_heads[slot];
+    m_heads[slot] = kNil;
+    return head;
+  }
+
+  void Release(std::uint32_t i) {
+    Node &n = m_nodes[i];
+    n.fn = Callback{};
+    n.active = false;
+    ++n.generation;
+    if (n.generation == 0)
+      n.generation = 1;
+    n.next = m_free;
+    m_free = i;
+  }
+
+  // 上の段から順に、下位がすべて 0 になった段のスロットを入れ直す
+  void Cascade() {
+    if ((m_now & 0xFFFFFFFFu) == 0)
+      Relink(Detach(kOverflow));
+    for (int level = kLevels - 1; level >= 1; --level) {
+      const std::uint64_t low = (std::uint64_t{1} << (level * kLevelBits)) - 1;
+      if ((m_now & low) == 0)
+        Relink(Detach(SlotOf(level, m_now)));
+    }
+  }
+
+  void Relink(std::uint32_t i) {
+    while (i != kNil) {
+      const std::uint32_t next = m_nodes[i].next;
+      Link(i);
+      i = next;
+    }
+  }
+
+  std::vector<Node> m_nodes;
+  std::vector<std::uint32_t> m_heads; // 各スロットの先頭（最後が溢れリスト）
+  std::uint32_t m_free = kNil;
+  size_t m_count = 0;
+  std::uint64_t m_now;
+};
+
+// ==============================
+//  タイマーサービス
+//   steady_clock の経過時間を tick に直してホイールを進める駆動スレッドを
+//   1本持つ。予約・取り消しはどのスレッドからでもよく、コールバックは
+//   必ず駆動スレッドから（排他を外してから）呼ばれる。
+//   駆動スレッドは次に発火か入れ直しがある tick まで眠る（予約が無ければ
+//   次の予約まで）。それより早い予約が入ったときだけ起こし直す
+//   破棄すると未発火の予約は呼ばれずに捨てられる
+// ==============================
+template <class Callback> class BasicTimerService {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit BasicTimerService(
+      Clock::duration tick = std::chrono::milliseconds(1))
+      : m_tick(tick), m_start(Clock::now()) {
+    m_thread = std::thread([this] { Run(); });
+  }
+  ~BasicTimerService() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+  }
+  BasicTimerService(const BasicTimerService &) = delete;
+  BasicTimerService &operator=(const BasicTimerService &) = delete;
+
+  // delay 後に fn を呼ぶ（tick 単位に切り上げるので早く呼ばれることはない）
+  TimerId Schedule(Clock::duration delay, Callback fn) {
+    const Clock::duration due = Clock::now() + delay - m_start;
+    const std::uint64_t expiry = static_cast<std::uint64_t>(
+        (due + m_tick - Clock::duration(1)) / m_tick);
+    bool wake;
+    TimerId id;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_wheel.empty()) // 眠っていた間の tick を飛ばす
+        m_wheel.Advance(TickAt(Clock::now()), [](Callback &&) {});
+      id = m_wheel.Schedule(expiry, std::move(fn));
+      wake = expiry < m_wakeTick; // 駆動スレッドが起きる予定より早い
+      if (wake)
+        m_wakeTick = expiry;
+    }
+    if (wake)
+      m_cv.notify_one();
+    return id;
+  }
+
+  bool Cancel(TimerId id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_wheel.Cancel(id))
+      return false;
+    if (m_wheel.empty() && m_firing == 0)
+      m_idle.notify_all();
+    return true;
+  }
+
+  size_t pending() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_wheel.size() + m_firing;
+  }
+
+  // 予約がすべて発火する（か取り消される）まで待つ
+  void WaitIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_wheel.empty() && m_firing == 0; });
+  }
+
+private:
+  std::uint64_t TickAt(Clock::time_point t) const {
+    return static_cast<std::uint64_t>((t - m_start) / m_tick);
+  }
+
+  void Run() {
+    std::vector<Callback> ready;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop) {
+      if (m_wheel.empty()) {
+        m_wakeTick = BasicTimerWheel<Callback>::kNever;
+        m_cv.wait(lock, [this] { return m_stop || !m_wheel.empty(); });
+        continue;
+      }
+      // 次に何か起きる tick まで眠る。より早い予約が入れば測り直す
+      const std::uint64_t target = m_wheel.NextEventTick();
+      m_wakeTick = target;
+      const Clock::time_point next =
+          m_start + m_tick * static_cast<Clock::rep>(target);
+      if (m_cv.wait_until(lock, next, [this, target] {
+            return m_stop || m_wakeTick != target;
+          }))
+        continue;
+
+      m_wheel.Advance(TickAt(Clock::now()), [&ready](Callback &&fn) {
+        ready.push_back(std::move(fn));
+      });
+      if (ready.empty())
+        continue;
+      m_firing = ready.size();
+      lock.unlock();
+      for (auto &fn : ready)
+        fn();
+      ready.clear();
+      lock.lock();
+      m_firing = 0;
+      if (m_wheel.empty())
+        m_idle.notify_all();
+    }
+  }
+
+  const Clock::duration m_tick;
+  const Clock::time_point m_start;
+  BasicTimerWheel<Callback> m_wheel;
+  size_t m_firing = 0; // 排他の外で呼んでいる最中の数
+  std::uint64_t m_wakeTick = BasicTimerWheel<Callback>::kNever; // 次に起きる tick
+  bool m_stop = false;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::condition_variable m_idle;
+  std::thread m_thread;
+};
+
+using TimerWheel = BasicTimerWheel<std::function<void()>>;
+using TimerService = BasicTimerService<std::function<void()>>;
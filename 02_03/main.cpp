@@ -1,16 +1,38 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
-#include <windows.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DiceSim.h"
+#include "TimerWheel.h"
 
 // プロトタイプ宣言
 void DelayReveal(void (*fn)(int, int), unsigned int delayMs, int roll,
                  int userGuess);
+TimerId DelayReveal(TimerService &timers, void (*fn)(int, int),
+                    unsigned int delayMs, int roll, int userGuess);
 void ShowResult(int roll, int userGuess);
+static void RunBenchmarks();
+static int RunSimulation(int argc, char *argv[]);
+
+int main(int argc, char *argv[]) {
+  if (argc >= 2 && std::string(argv[1]) == "--bench") {
+    RunBenchmarks();
+    return 0;
+  }
+  if (argc >= 2 && std::string(argv[1]) == "--simulate")
+    return RunSimulation(argc, argv);
 
-int main(void) {
   // 乱数シード初期化
-  srand((unsigned int)time(NULL));
+  Xoshiro256pp rng(static_cast<std::uint64_t>(time(NULL)));
 
   int userGuess = 0;
 
@@ -24,8 +46,8 @@ int main(void) {
     return 1;
   }
 
-  // サイコロの出目（1～6）
-  int roll = (rand() % 6) + 1;
+  // サイコロの出目（1～6、偏りなし）
+  int roll = static_cast<int>(rng.Below(6)) + 1;
 
   // 3秒後に結果表示
   DelayReveal(ShowResult, 3000, roll, userGuess);
@@ -34,10 +56,22 @@ int main(void) {
 }
 
 // 遅延実行関数
+//  以前と同じく fn が呼ばれるまで戻らない。既定の TimerService に予約して
+//  待つ（このサービスはここでしか使わないので、空になれば fn は済んでいる）
 void DelayReveal(void (*fn)(int, int), unsigned int delayMs, int roll,
                  int userGuess) {
-  Sleep(delayMs);
-  fn(roll, userGuess);
+  static TimerService timers;
+  DelayReveal(timers, fn, delayMs, roll, userGuess);
+  timers.WaitIdle();
+}
+
+// 遅延実行関数（予約だけして戻る版）
+//  スレッドを止めずにタイマーへ予約する。fn は timers の駆動スレッドから
+//  呼ばれ、戻り値の ID で取り消せる
+TimerId DelayReveal(TimerService &timers, void (*fn)(int, int),
+                    unsigned int delayMs, int roll, int userGuess) {
+  return timers.Schedule(std::chrono::milliseconds(delayMs),
+                         [fn, roll, userGuess] { fn(roll, userGuess); });
 }
 
 // 判定・結果表示関数
@@ -52,3 +86,214 @@ void ShowResult(int roll, int userGuess) {
     printf("不正解\n");
   }
 }
+
+using BenchClock = std::chrono::steady_clock;
+
+static double ElapsedMs(BenchClock::time_point t0) {
+  return std::chrono::duration<double, std::milli>(BenchClock::now() - t0)
+      .count();
+}
+
+// ==============================
+//  シミュレーション（表示も待ちもせずに大量に遊ぶ）
+//   使い方: 02_03.exe --simulate [回数] [--threads N] [--seed S]
+//   予想の仕方ごとの勝率（95% 信頼区間つき）と出目の割合、1秒あたりの回数
+//   同じ回数と seed なら、スレッド数を変えても結果は同じ
+// ==============================
+static bool ParseU64(const char *text, std::uint64_t &value) {
+  char *end = nullptr;
+  value = strtoull(text, &end, 10);
+  return end != text && *end == '\0';
+}
+
+static int RunSimulation(int argc, char *argv[]) {
+  std::uint64_t rounds = 1000000000;
+  std::uint64_t seed = 2025;
+  std::uint64_t threads = 0;
+  for (int i = 2; i < argc; ++i) {
+    const std::string arg = argv[i];
+    std::uint64_t value = 0;
+    if ((arg == "--threads" || arg == "--seed") && i + 1 < argc &&
+        ParseU64(argv[i + 1], value)) {
+      (arg == "--seed" ? seed : threads) = value;
+      ++i;
+    } else if (arg[0] != '-' && ParseU64(argv[i], value) && value > 0) {
+      rounds = value;
+    } else {
+      fprintf(stderr, "[Error] 引数が不正です: %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (threads > dice_sim::kMaxThreads) {
+    fprintf(stderr, "[Error] --threads は 0〜%u で指定してください: %llu\n",
+            dice_sim::kMaxThreads, static_cast<unsigned long long>(threads));
+    return 1;
+  }
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+
+  const auto t0 = BenchClock::now();
+  const dice_sim::Result result =
+      dice_sim::Simulate(rounds, seed, static_cast<unsigned>(threads));
+  const double ms = ElapsedMs(t0);
+
+  const double n = static_cast<double>(result.rounds);
+  printf("===== cho-han simulation =====\n");
+  printf("rounds   : %llu (seed %llu, %llu threads)\n",
+         static_cast<unsigned long long>(result.rounds),
+         static_cast<unsigned long long>(seed),
+         static_cast<unsigned long long>(threads));
+  printf("time     : %.1f ms (%.1f M rounds / s)\n\n", ms,
+         n / (ms * 1e3));
+  printf("%-20s %10s %10s\n", "strategy", "win rate", "95% +-");
+  for (int s = 0; s < dice_sim::kStrategyCount; ++s) {
+    const double p = result.wins[s] / n;
+    printf("%-20s %10.6f %10.6f\n", dice_sim::StrategyName(s), p,
+           1.96 * std::sqrt(p * (1.0 - p) / n));
+  }
+  printf("\nfaces    :");
+  for (int f = 0; f < 6; ++f)
+    printf(" %d:%.6f", f + 1, result.faces[f] / n);
+  printf("\n");
+  return 0;
+}
+
+// ==============================
+//  ベンチマーク
+//   使い方: 02_03.exe --bench
+//   1M 件の予約・取り消し・発火の速さと、実時間で動かしたときの遅れ
+//   丁半のシミュレーションの rand() との比較と、スレッド数ごとの速さ
+// ==============================
+static volatile std::uint64_t g_benchSink;
+
+static void RunBenchmarks() {
+  const size_t kTimers = 1000000;
+  std::mt19937 rng(2025);
+
+  // ホイール単体（スレッドなし）
+  {
+    std::uniform_int_distribution<std::uint64_t> delay(1, 60000);
+    std::vector<std::uint64_t> expiry(kTimers);
+    for (auto &e : expiry)
+      e = delay(rng);
+
+    TimerWheel wheel;
+    std::vector<TimerId> ids(kTimers);
+    size_t fired = 0;
+    auto t0 = BenchClock::now();
+    for (size_t i = 0; i < kTimers; ++i)
+      ids[i] = wheel.Schedule(expiry[i], [&fired] { ++fired; });
+    const double scheduleMs = ElapsedMs(t0);
+
+    t0 = BenchClock::now();
+    size_t cancelled = 0;
+    for (size_t i = 0; i < kTimers; i += 2)
+      cancelled += wheel.Cancel(ids[i]);
+    const double cancelMs = ElapsedMs(t0);
+
+    t0 = BenchClock::now();
+    wheel.Advance(60000, [](std::function<void()> &&fn) { fn(); });
+    const double fireMs = ElapsedMs(t0);
+
+    printf("===== wheel only, %zu timers (1..60000 ticks) =====\n", kTimers);
+    printf("schedule : %8.1f ms (%6.1f ns / timer)\n", scheduleMs,
+           scheduleMs * 1e6 / kTimers);
+    printf("cancel   : %8.1f ms (%6.1f ns / timer)\n", cancelMs,
+           cancelMs * 1e6 / cancelled);
+    printf("advance  : %8.1f ms (%zu fired%s)\n", fireMs, fired,
+           fired + cancelled == kTimers ? "" : "  [count mismatch]");
+
+    // まばらな予約：空の tick を飛ばすので、進める幅ではなく予約の数で決まる
+    const size_t kSparse = 1000;
+    const std::uint64_t kSparseSpan = std::uint64_t{1} << 36;
+    std::uniform_int_distribution<std::uint64_t> far(1, kSparseSpan);
+    TimerWheel sparse;
+    size_t sparseFired = 0;
+    for (size_t i = 0; i < kSparse; ++i)
+      sparse.Schedule(far(rng), [&sparseFired] { ++sparseFired; });
+    t0 = BenchClock::now();
+    sparse.Advance(kSparseSpan, [](std::function<void()> &&fn) { fn(); });
+    printf("sparse   : %8.1f ms (%zu timers over 2^36 ticks%s)\n\n",
+           ElapsedMs(t0), kSparse,
+           sparseFired == kSparse ? "" : "  [count mismatch]");
+  }
+
+  // 実時間：2秒の間に散らばった 1M 件の予約が、予定からどれだけ遅れたか
+  {
+    const auto kSpan = std::chrono::milliseconds(2000);
+    std::uniform_int_distribution<long long> delayUs(
+        0, std::chrono::duration_cast<std::chrono::microseconds>(kSpan)
+               .count());
+    std::vector<long long> lateUs(kTimers, -1);
+    std::atomic<size_t> done{0};
+
+    TimerService timers;
+    const auto t0 = BenchClock::now();
+    for (size_t i = 0; i < kTimers; ++i) {
+      const auto delay = std::chrono::microseconds(delayUs(rng));
+      const auto due = BenchClock::now() + delay;
+      timers.Schedule(delay, [&lateUs, &done, i, due] {
+        lateUs[i] = std::chrono::duration_cast<std::chrono::microseconds>(
+                        BenchClock::now() - due)
+                        .count();
+        done.fetch_add(1, std::memory_order_relaxed);
+      });
+    }
+    const double scheduleMs = ElapsedMs(t0);
+    timers.WaitIdle();
+
+    std::sort(lateUs.begin(), lateUs.end());
+    const auto pct = [&lateUs](double p) {
+      return lateUs[static_cast<size_t>(p * (lateUs.size() - 1))] / 1000.0;
+    };
+    printf("===== timer service, %zu timers over %lld ms =====\n", kTimers,
+           static_cast<long long>(kSpan.count()));
+    printf("schedule : %8.1f ms (%6.1f ns / timer, incl. lock)\n",
+           scheduleMs, scheduleMs * 1e6 / kTimers);
+    printf("late (ms): min %.3f  p50 %.3f  p99 %.3f  max %.3f%s\n", pct(0.0),
+           pct(0.5), pct(0.99), pct(1.0),
+           done == kTimers && lateUs.front() >= 0 ? "" : "  [early or lost]");
+  }
+  // 丁半：rand() % 6 で1回ずつ振る場合と、DiceSim をスレッド数を変えて
+  {
+    const std::uint64_t kRandRounds = std::uint64_t{1} << 26;
+    srand(2025);
+    std::uint64_t odd = 0;
+    auto t0 = BenchClock::now();
+    for (std::uint64_t i = 0; i < kRandRounds; ++i)
+      odd += ((rand() % 6) + 1) & 1;
+    const double randMs = ElapsedMs(t0);
+    g_benchSink = odd;
+
+    const std::uint64_t kRounds = std::uint64_t{1} << 28;
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    printf("\n===== cho-han simulation, %llu rounds =====\n",
+           static_cast<unsigned long long>(kRounds));
+    printf("%-12s %10s %14s %8s\n", "generator", "ms", "M rounds / s",
+           "scaling");
+    printf("%-12s %10.1f %14.1f %8s\n", "rand() x1", randMs,
+           kRandRounds / (randMs * 1e3), "-");
+
+    dice_sim::Result first;
+    double oneThreadMs = 0.0;
+    for (unsigned threads = 1;; threads = std::min(threads * 2, hw)) {
+      t0 = BenchClock::now();
+      const dice_sim::Result r = dice_sim::Simulate(kRounds, 2025, threads);
+      const double ms = ElapsedMs(t0);
+      bool same = true;
+      if (threads == 1) {
+        first = r;
+        oneThreadMs = ms;
+      } else {
+        for (int s = 0; s < dice_sim::kStrategyCount; ++s)
+          same = same && r.wins[s] == first.wins[s];
+      }
+      const std::string label = "xoshiro x" + std::to_string(threads);
+      printf("%-12s %10.1f %14.1f %7.2fx%s\n", label.c_str(), ms,
+             kRounds / (ms * 1e3), oneThreadMs / ms,
+             same ? "" : "  [result mismatch]");
+      if (threads == hw)
+        break;
+    }
+  }
+}
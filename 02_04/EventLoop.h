@@ -0,0 +1,270 @@
+// EventLoop.h
+#pragma once
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional> // std::greater
+#include <queue>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// ==============================
+//  コルーチンのタスク
+//   呼んだだけでは動かず、co_await されたときに始まる。
+//   終わると待っていた側へそのまま戻る（対称転送なのでスタックが伸びない）
+//   中で投げた例外は co_await した側で投げ直す
+// ==============================
+template <class T = void> class Task;
+
+namespace event_loop_detail {
+
+// 終わったら待っていた側を再開する
+struct FinalAwaiter {
+  bool await_ready() const noexcept { return false; }
+  template <class Promise>
+  std::coroutine_handle<>
+  await_suspend(std::coroutine_handle<Promise> h) const noexcept {
+    if (h.promise().continuation)
+      return h.promise().continuation;
+    return std::noop_coroutine();
+  }
+  void await_resume() const noexcept {}
+};
+
+struct PromiseBase {
+  std::suspend_always initial_suspend() const noexcept { return {}; }
+  FinalAwaiter final_suspend() const noexcept { return {}; }
+  std::coroutine_handle<> continuation;
+};
+
+template <class T> struct Promise : PromiseBase {
+  Task<T> get_return_object() noexcept;
+  template <class U> void return_value(U &&value) {
+    result.template emplace<1>(std::forward<U>(value));
+  }
+  void unhandled_exception() noexcept {
+    result.template emplace<2>(std::current_exception());
+  }
+  T Take() {
+    if (result.index() == 2)
+      std::rethrow_exception(std::get<2>(result));
+    return std::move(std::get<1>(result));
+  }
+  std::variant<std::monostate, T, std::exception_ptr> result;
+};
+
+template <> struct Promise<void> : PromiseBase {
+  Task<void> get_return_object() noexcept;
+  void return_void() noexcept {}
+  void unhandled_exception() noexcept { error = std::current_exception(); }
+  void Take() {
+    if (error)
+      std::rethrow_exception(error);
+  }
+  std::exception_ptr error;
+};
+
+} // namespace event_loop_detail
+
+template <class T> class [[nodiscard]] Task {
+public:
+  using promise_type = event_loop_detail::Promise<T>;
+
+  Task(Task &&other) noexcept : m_h(std::exchange(other.m_h, {})) {}
+  Task &operator=(Task &&other) noexcept {
+    if (this != &other) {
+      if (m_h)
+        m_h.destroy();
+      m_h = std::exchange(other.m_h, {});
+    }
+    return *this;
+  }
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+  ~Task() {
+    if (m_h)
+      m_h.destroy();
+  }
+
+  bool await_ready() const noexcept { return false; }
+  std::coroutine_handle<>
+  await_suspend(std::coroutine_handle<> awaiting) noexcept {
+    m_h.promise().continuation = awaiting;
+    return m_h;
+  }
+  T await_resume() { return m_h.promise().Take(); }
+
+private:
+  friend promise_type;
+  explicit Task(std::coroutine_handle<promise_type> h) noexcept : m_h(h) {}
+
+  std::coroutine_handle<promise_type> m_h;
+};
+
+namespace event_loop_detail {
+template <class T> Task<T> Promise<T>::get_return_object() noexcept {
+  return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+inline Task<void> Promise<void>::get_return_object() noexcept {
+  return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+} // namespace event_loop_detail
+
+// ==============================
+//  1スレッドのイベントループ
+//   Spawn したタスクを順に動かし、SleepFor で眠ったものは満了時刻の
+//   ヒープに積む。待っている間にスレッドを使わないので、何千もの
+//   「待ってから表示」を1本のスレッドで交互に進められる
+//   ClockMode::Virtual では実時間を待たずに次の満了時刻へ時計を飛ばす
+//   （何時間分の予定も一瞬で流れる。順番と Now() は実時間と同じ）
+//   Spawn・SleepFor・Run は同じスレッドから呼ぶこと
+// ==============================
+enum class ClockMode { Real, Virtual };
+
+class EventLoop {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit EventLoop(ClockMode mode = ClockMode::Real)
+      : m_mode(mode),
+        m_now(mode == ClockMode::Virtual ? Clock::time_point{}
+                                         : Clock::now()) {}
+  ~EventLoop() {
+    // 走り切らなかったタスクは、外側から順に（中のタスクごと）捨てる
+    for (void *frame : m_roots)
+      std::coroutine_handle<>::from_address(frame).destroy();
+  }
+  EventLoop(const EventLoop &) = delete;
+  EventLoop &operator=(const EventLoop &) = delete;
+
+  Clock::time_point Now() const {
+    return m_mode == ClockMode::Virtual ? m_now : Clock::now();
+  }
+  ClockMode mode() const { return m_mode; }
+  // 走っている（終わっていない）Spawn したタスクの数
+  size_t active() const { return m_roots.size(); }
+
+  // task を次の Run で動かし始める（持ち主はループになる）
+  void Spawn(Task<void> task) {
+    Root root = Start(std::move(task));
+    m_roots.insert(root.h.address());
+    m_ready.push_back(root.h);
+  }
+
+  // 一定時間眠る（co_await loop.SleepFor(...)）
+  auto SleepFor(Clock::duration delay) {
+    struct Awaiter {
+      EventLoop &loop;
+      Clock::time_point due;
+      bool await_ready() const noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> h) {
+        loop.m_timers.push(Timer{due, loop.m_seq++, h});
+      }
+      void await_resume() const noexcept {}
+    };
+    return Awaiter{*this, Now() + delay};
+  }
+
+  // 他の準備済みのタスクに順番を譲る
+  auto Yield() {
+    struct Awaiter {
+      EventLoop &loop;
+      bool await_ready() const noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> h) {
+        loop.m_ready.push_back(h);
+      }
+      void await_resume() const noexcept {}
+    };
+    return Awaiter{*this};
+  }
+
+  // 動けるタスクと予約が無くなるまで回す。
+  // Spawn したタスクが投げた例外は、最初の1つをここで投げ直す
+  void Run() {
+    for (;;) {
+      while (!m_ready.empty()) {
+        const std::coroutine_handle<> h = m_ready.front();
+        m_ready.pop_front();
+        h.resume();
+      }
+      if (m_error)
+        std::rethrow_exception(std::exchange(m_error, nullptr));
+      if (m_timers.empty())
+        break;
+
+      const Clock::time_point due = m_timers.top().due;
+      if (m_mode == ClockMode::Virtual)
+        m_now = due;
+      else
+        std::this_thread::sleep_until(due);
+      // 満了したものを予約順に準備済みへ（起こした先で予約されたものは次の周）
+      const Clock::time_point now = Now();
+      while (!m_timers.empty() && m_timers.top().due <= now) {
+        m_ready.push_back(m_timers.top().h);
+        m_timers.pop();
+      }
+    }
+  }
+
+private:
+  struct Timer {
+    Clock::time_point due;
+    std::uint64_t seq; // 同じ時刻なら予約した順
+    std::coroutine_handle<> h;
+    bool operator>(const Timer &other) const {
+      return due != other.due ? due > other.due : seq > other.seq;
+    }
+  };
+
+  // Spawn したタスクを包む最外のコルーチン。終わったら自分を片付ける
+  struct Root {
+    struct promise_type {
+      EventLoop *loop = nullptr;
+      Root get_return_object() noexcept {
+        return {std::coroutine_handle<promise_type>::from_promise(*this)};
+      }
+      std::suspend_always initial_suspend() const noexcept { return {}; }
+      auto final_suspend() const noexcept {
+        struct Awaiter {
+          bool await_ready() const noexcept { return false; }
+          void await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+            EventLoop *loop = h.promise().loop;
+            loop->m_roots.erase(h.address());
+            h.destroy();
+          }
+          void await_resume() const noexcept {}
+        };
+        return Awaiter{};
+      }
+      void return_void() noexcept {}
+      void unhandled_exception() noexcept {
+        if (!loop->m_error)
+          loop->m_error = std::current_exception();
+      }
+    };
+    std::coroutine_handle<promise_type> h;
+  };
+
+  Root Start(Task<void> task) {
+    // 最初の一歩より前に loop を入れておく（initial_suspend で止まっている）
+    Root root = RunRoot(std::move(task));
+    root.h.promise().loop = this;
+    return root;
+  }
+  static Root RunRoot(Task<void> task) { co_await std::move(task); }
+
+  const ClockMode m_mode;
+  Clock::time_point m_now; // 仮想時計の現在時刻
+  std::uint64_t m_seq = 0;
+  std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> m_timers;
+  std::deque<std::coroutine_handle<>> m_ready;
+  std::unordered_set<void *> m_roots; // 走っている Root のフレーム
+  std::exception_ptr m_error;
+};
@@ -0,0 +1,181 @@
+// InplaceFunction.h
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <functional> // std::invoke, std::bad_function_call
+#include <memory>     // std::addressof
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// ==============================
+//  ヒープを使わない関数オブジェクト（ムーブのみ）
+//   キャプチャは Capacity バイトの内部バッファに置く。入らない大きさなら
+//   コンパイルエラーにする（こっそりヒープに逃がさない）
+//   std::function との違い
+//     - コピーできない（ムーブだけ）ので、中身もムーブできれば足りる
+//     - 呼び出しは関数ポインタ1回。中身が自明にコピーできる型なら
+//       ムーブはその大きさの memcpy、破棄は何もしない
+//   空のまま呼ぶと std::function と同じく std::bad_function_call を投げる
+//   （置き換えても空の扱いが変わらないように）
+// ==============================
+template <class Signature, size_t Capacity = 32> class InplaceFunction;
+
+template <class R, class... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> {
+public:
+  InplaceFunction() noexcept = default;
+  InplaceFunction(std::nullptr_t) noexcept {}
+
+  template <class F, class D = std::decay_t<F>,
+            class = std::enable_if_t<!std::is_same_v<D, InplaceFunction> &&
+                                     std::is_invocable_r_v<R, D &, Args...>>>
+  InplaceFunction(F &&f) {
+    static_assert(sizeof(D) <= Capacity,
+                  "キャプチャが大きすぎます（Capacity を増やしてください）");
+    static_assert(alignof(D) <= alignof(std::max_align_t),
+                  "アラインメントが大きすぎます");
+    static_assert(std::is_nothrow_move_constructible_v<D>,
+                  "ムーブで例外を投げる型は入れられません");
+    ::new (static_cast<void *>(m_buf)) D(std::forward<F>(f));
+    m_ops = OpsFor<D>();
+  }
+
+  InplaceFunction(InplaceFunction &&other) noexcept { MoveFrom(other); }
+  InplaceFunction &operator=(InplaceFunction &&other) noexcept {
+    if (this != &other) {
+      Reset();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+  InplaceFunction(const InplaceFunction &) = delete;
+  InplaceFunction &operator=(const InplaceFunction &) = delete;
+  ~InplaceFunction() { Reset(); }
+
+  explicit operator bool() const noexcept { return m_ops != nullptr; }
+
+  R operator()(Args... args) {
+    if (!m_ops)
+      throw std::bad_function_call();
+    return m_ops->invoke(m_buf, std::forward<Args>(args)...);
+  }
+
+private:
+  // destroy が nullptr なら破棄は何もしなくてよい型
+  struct Ops {
+    R (*invoke)(void *, Args &&...);
+    void (*move)(void *dst, void *src);
+    void (*destroy)(void *);
+  };
+
+  template <class D> static R Invoke(void *p, Args &&...args) {
+    if constexpr (std::is_void_v<R>)
+      std::invoke(*static_cast<D *>(p), std::forward<Args>(args)...);
+    else
+      return std::invoke(*static_cast<D *>(p), std::forward<Args>(args)...);
+  }
+  template <class D> static void Move(void *dst, void *src) {
+    if constexpr (kTrivial<D>) {
+      // 大きさがコンパイル時に決まるので数命令のコピーになる
+      std::memcpy(dst, src, sizeof(D));
+    } else {
+      ::new (dst) D(std::move(*static_cast<D *>(src)));
+      static_cast<D *>(src)->~D();
+    }
+  }
+  template <class D> static void Destroy(void *p) {
+    static_cast<D *>(p)->~D();
+  }
+
+  template <class D>
+  static constexpr bool kTrivial = std::is_trivially_copyable_v<D> &&
+                                   std::is_trivially_destructible_v<D>;
+
+  template <class D> static const Ops *OpsFor() {
+    static const Ops ops = {&Invoke<D>, &Move<D>,
+                            kTrivial<D> ? nullptr : &Destroy<D>};
+    return &ops;
+  }
+
+  void MoveFrom(InplaceFunction &other) noexcept {
+    m_ops = other.m_ops;
+    if (!m_ops)
+      return;
+    m_ops->move(m_buf, other.m_buf);
+    other.m_ops = nullptr;
+  }
+
+  void Reset() noexcept {
+    if (m_ops && m_ops->destroy)
+      m_ops->destroy(m_buf);
+    m_ops = nullptr;
+  }
+
+  alignas(std::max_align_t) unsigned char m_buf[Capacity];
+  const Ops *m_ops = nullptr;
+};
+
+// ==============================
+//  持ち主にならない関数の参照（同期呼び出し用）
+//   関数オブジェクト（ラムダなど）へのポインタと呼び出し用の関数ポインタ
+//   だけを持つ。確保もコピーもしないので、参照先が呼び出しの間だけ
+//   生きていればよい場面（その場で呼んで返る関数の引数）に使う
+//   関数（関数名・関数ポインタ）はポインタの値そのものを持つので、
+//   一時的なポインタを渡しても参照先が消えることはない
+//   空の状態は無い（既定の構築はできず、nullptr の関数ポインタは assert で弾く）
+// ==============================
+template <class Signature> class FunctionRef;
+
+template <class R, class... Args> class FunctionRef<R(Args...)> {
+public:
+  template <class F,
+            class = std::enable_if_t<
+                !std::is_same_v<std::decay_t<F>, FunctionRef> &&
+                !std::is_function_v<std::remove_pointer_t<std::decay_t<F>>> &&
+                std::is_invocable_r_v<R, F &, Args...>>>
+  FunctionRef(F &&f) noexcept : m_call(&Call<std::remove_reference_t<F>>) {
+    m_target.obj =
+        const_cast<void *>(static_cast<const void *>(std::addressof(f)));
+  }
+
+  template <class F, class = std::enable_if_t<
+                         std::is_function_v<F> &&
+                         std::is_invocable_r_v<R, F &, Args...>>>
+  FunctionRef(F *fn) noexcept : m_call(&CallFunction<F>) {
+    assert(fn != nullptr && "FunctionRef に nullptr は渡せません");
+    m_target.fn = reinterpret_cast<void (*)()>(fn);
+  }
+
+  R operator()(Args... args) const {
+    return m_call(m_target, std::forward<Args>(args)...);
+  }
+
+private:
+  // 関数オブジェクトのアドレスか、関数ポインタ（型を消して持つ）
+  union Target {
+    void *obj;
+    void (*fn)();
+  };
+
+  template <class F> static R Call(Target t, Args &&...args) {
+    if constexpr (std::is_void_v<R>)
+      std::invoke(*static_cast<F *>(t.obj), std::forward<Args>(args)...);
+    else
+      return std::invoke(*static_cast<F *>(t.obj),
+                         std::forward<Args>(args)...);
+  }
+
+  template <class F> static R CallFunction(Target t, Args &&...args) {
+    if constexpr (std::is_void_v<R>)
+      std::invoke(reinterpret_cast<F *>(t.fn), std::forward<Args>(args)...);
+    else
+      return std::invoke(reinterpret_cast<F *>(t.fn),
+                         std::forward<Args>(args)...);
+  }
+
+  Target m_target;
+  R (*m_call)(Target, Args &&...);
+};
@@ -1,16 +1,36 @@
-#include <functional> // std::function
+#include <functional> // std::function（ベンチマークの比較用）
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
-#include <windows.h>
 
-// プロトタイプ宣言（std::function を受け取る）
-void DelayReveal(std::function<void(int, int)> fn, unsigned int delayMs,
-                 int roll, int userGuess);
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../02_03/DiceSim.h"
+#include "EventLoop.h"
+#include "InplaceFunction.h"
+
+// 結果表示のコールバック（キャプチャは内部バッファに置き、ヒープを使わない）
+using RevealFn = InplaceFunction<void(int, int)>;
+
+// プロトタイプ宣言
+Task<void> DelayReveal(EventLoop &loop, RevealFn fn, unsigned int delayMs,
+                       int roll, int userGuess);
+static void RunBenchmarks();
+
+int main(int argc, char *argv[]) {
+  if (argc >= 2 && std::string(argv[1]) == "--bench") {
+    RunBenchmarks();
+    return 0;
+  }
+
+  EventLoop loop;
 
-int main(void) {
   // 乱数シード初期化
-  srand((unsigned int)time(NULL));
+  Xoshiro256pp rng(static_cast<std::uint64_t>(time(NULL)));
 
   int userGuess = 0;
 
@@ -24,11 +44,11 @@ int main(void) {
     return 1;
   }
 
-  // サイコロの出目（1～6）
-  int roll = (rand() % 6) + 1;
+  // サイコロの出目（1～6、偏りなし）
+  int roll = static_cast<int>(rng.Below(6)) + 1;
 
   // 判定・結果表示（ラムダ式）
-  std::function<void(int, int)> showResult = [](int roll, int userGuess) {
+  auto showResult = [](int roll, int userGuess) {
     // 1行目：出目表示
     printf("出目は %d でした。\n", roll);
 
@@ -40,15 +60,196 @@ int main(void) {
     }
   };
 
-  // 3秒後に結果表示（DelayReveal にラムダを渡す）
-  DelayReveal(showResult, 3000, roll, userGuess);
+  // 3秒後に結果表示（コルーチンをループに渡し、終わるまで回す）
+  loop.Spawn(DelayReveal(loop, showResult, 3000, roll, userGuess));
+  loop.Run();
 
   return 0;
 }
 
-// 遅延実行関数（std::function で受け取る）
-void DelayReveal(std::function<void(int, int)> fn, unsigned int delayMs,
-                 int roll, int userGuess) {
-  Sleep(delayMs);
+// 遅延実行関数（待つ間はスレッドを止めずにループへ戻る）
+Task<void> DelayReveal(EventLoop &loop, RevealFn fn, unsigned int delayMs,
+                       int roll, int userGuess) {
+  co_await loop.SleepFor(std::chrono::milliseconds(delayMs));
   fn(roll, userGuess);
 }
+
+// ==============================
+//  マイクロベンチマーク
+//   使い方: 02_04.exe --bench
+//   構築・ムーブ・呼び出しの1回あたりの時間を std::function と比べる
+// ==============================
+using BenchClock = std::chrono::steady_clock;
+
+static volatile int g_benchSink;
+
+template <class F> static double NsPerOp(int count, F body) {
+  const auto t0 = BenchClock::now();
+  for (int i = 0; i < count; ++i)
+    body(i);
+  return std::chrono::duration<double, std::nano>(BenchClock::now() - t0)
+             .count() /
+         count;
+}
+
+// fn を count 回その場で呼んで合計を返す
+//  fn は戻るまでしか使わないので、持ち主にならない FunctionRef で受け取る
+static int SumCalls(FunctionRef<int(int, int)> fn, int count) {
+  int sum = 0;
+  for (int i = 0; i < count; ++i)
+    sum += fn(i, 1);
+  return sum;
+}
+
+// SumCalls は volatile の関数ポインタ越しに呼ぶ。呼び出し元のラムダが
+// 見えたままだとインライン化されてループごと畳まれ、FunctionRef の
+// 間接呼び出しを測れない（std::function / InplaceFunction の列とそろえる）
+static int (*volatile g_sumCalls)(FunctionRef<int(int, int)>, int) = SumCalls;
+
+// Bytes バイトをキャプチャしたラムダで測る
+template <size_t Bytes> static void BenchCapture() {
+  struct Payload {
+    int values[Bytes / sizeof(int)];
+  };
+  Payload payload = {};
+  payload.values[0] = 1;
+  const auto lambda = [payload](int roll, int guess) {
+    return payload.values[0] + roll - guess;
+  };
+  using StdFn = std::function<int(int, int)>;
+  using InFn = InplaceFunction<int(int, int), 64>;
+  const int kCount = 2000000;
+
+  // 構築（と破棄）
+  const double stdCtor = NsPerOp(kCount, [&](int i) {
+    StdFn f = lambda;
+    g_benchSink = g_benchSink + f(i, 0);
+  });
+  const double inCtor = NsPerOp(kCount, [&](int i) {
+    InFn f = lambda;
+    g_benchSink = g_benchSink + f(i, 0);
+  });
+
+  // ムーブ（2つの間で行き来させる）
+  StdFn stdA = lambda, stdB;
+  InFn inA = lambda, inB;
+  const double stdMove = NsPerOp(kCount, [&](int) {
+    stdB = std::move(stdA);
+    stdA = std::move(stdB);
+  });
+  const double inMove = NsPerOp(kCount, [&](int) {
+    inB = std::move(inA);
+    inA = std::move(inB);
+  });
+
+  // 呼び出し（ref は SumCalls の引数として渡し、その中で呼ぶ）
+  int sum = 0;
+  const double stdCall = NsPerOp(kCount, [&](int i) { sum += stdA(i, 1); });
+  const double inCall = NsPerOp(kCount, [&](int i) { sum += inA(i, 1); });
+  const double refCall =
+      NsPerOp(1, [&](int) { sum += g_sumCalls(lambda, kCount); }) / kCount;
+  g_benchSink = sum;
+
+  printf("%-10zu %-9s %9.2f %9.2f %9s\n", Bytes, "ctor", stdCtor, inCtor,
+         "-");
+  printf("%-10s %-9s %9.2f %9.2f %9s\n", "", "move x2", stdMove, inMove,
+         "-");
+  printf("%-10s %-9s %9.2f %9.2f %9.2f\n", "", "invoke", stdCall, inCall,
+         refCall);
+}
+
+// ふつうの関数（関数名をそのまま渡す）で測る
+static int AddRoll(int roll, int guess) { return roll - guess; }
+
+static void BenchPlainFunction() {
+  using StdFn = std::function<int(int, int)>;
+  using InFn = InplaceFunction<int(int, int), 64>;
+  const int kCount = 2000000;
+  StdFn stdFn = AddRoll;
+  InFn inFn = AddRoll;
+  int sum = 0;
+  const double stdCall = NsPerOp(kCount, [&](int i) { sum += stdFn(i, 1); });
+  const double inCall = NsPerOp(kCount, [&](int i) { sum += inFn(i, 1); });
+  const double refCall =
+      NsPerOp(1, [&](int) { sum += g_sumCalls(AddRoll, kCount); }) / kCount;
+  g_benchSink = sum;
+  printf("%-10s %-9s %9.2f %9.2f %9.2f\n", "fn ptr", "invoke", stdCall,
+         inCall, refCall);
+}
+
+// ==============================
+//  コルーチンのイベントループ
+//   tasks 本のタスクがそれぞれ「0～maxDelay 待ってから出目を返す」を
+//   rounds 回繰り返す。仮想時計なら起きた時刻は予定とぴったり一致する
+// ==============================
+struct LoopStats {
+  std::uint64_t events = 0;
+  long long maxLateUs = 0;
+  bool early = false; // 予定より早く起きたものがあった
+};
+
+static Task<int> RollAfter(EventLoop &loop, Xoshiro256pp &rng,
+                           std::chrono::milliseconds delay,
+                           LoopStats &stats) {
+  const EventLoop::Clock::time_point due = loop.Now() + delay;
+  co_await loop.SleepFor(delay);
+  const long long lateUs =
+      std::chrono::duration_cast<std::chrono::microseconds>(loop.Now() - due)
+          .count();
+  stats.early = stats.early || lateUs < 0;
+  stats.maxLateUs = std::max(stats.maxLateUs, lateUs);
+  ++stats.events;
+  co_return static_cast<int>(rng.Below(6)) + 1;
+}
+
+static Task<void> PlayRounds(EventLoop &loop, std::uint64_t seed, int rounds,
+                             std::uint32_t maxDelayMs, LoopStats &stats) {
+  Xoshiro256pp rng(seed);
+  int odd = 0;
+  for (int r = 0; r < rounds; ++r) {
+    const std::chrono::milliseconds delay(rng.Below(maxDelayMs + 1));
+    odd += co_await RollAfter(loop, rng, delay, stats) % 2;
+  }
+  g_benchSink = g_benchSink + odd;
+}
+
+static void BenchEventLoop(ClockMode mode, int tasks, int rounds,
+                           std::uint32_t maxDelayMs) {
+  EventLoop loop(mode);
+  LoopStats stats;
+  const EventLoop::Clock::time_point start = loop.Now();
+  for (int t = 0; t < tasks; ++t)
+    loop.Spawn(PlayRounds(loop, t, rounds, maxDelayMs, stats));
+  const auto t0 = BenchClock::now();
+  loop.Run();
+  const double wallMs =
+      std::chrono::duration<double, std::milli>(BenchClock::now() - t0)
+          .count();
+  const double loopSec =
+      std::chrono::duration<double>(loop.Now() - start).count();
+
+  const bool ok = stats.events == static_cast<std::uint64_t>(tasks) * rounds &&
+                  !stats.early &&
+                  (mode == ClockMode::Real || stats.maxLateUs == 0);
+  printf("%-8s %6d x %-3d %8llu %12.1f %10.1f %10.3f%s\n",
+         mode == ClockMode::Virtual ? "virtual" : "real", tasks, rounds,
+         static_cast<unsigned long long>(stats.events), loopSec, wallMs,
+         stats.maxLateUs / 1000.0, ok ? "" : "  [early, late or lost]");
+}
+
+static void RunBenchmarks() {
+  printf("===== coroutine event loop (1 thread) =====\n");
+  printf("%-8s %12s %8s %12s %10s %10s\n", "clock", "tasks x rnd",
+         "events", "clock (s)", "wall (ms)", "late (ms)");
+  BenchEventLoop(ClockMode::Virtual, 10000, 10, 3600 * 1000); // 最大1時間
+  BenchEventLoop(ClockMode::Real, 10000, 3, 200);
+  printf("\n");
+
+  printf("===== callback types (ns / op) =====\n");
+  printf("%-10s %-9s %9s %9s %9s\n", "capture", "op", "function", "inplace",
+         "ref");
+  BenchCapture<8>();
+  BenchCapture<16>();
+  BenchCapture<48>();
+  BenchPlainFunction();
+}
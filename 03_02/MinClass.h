@@ -0,0 +1,204 @@
+// MinClass.h
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits> // std::common_type_t
+
+// SSE2 は x64 なら常に使える。AVX2 は /arch:AVX2（-mavx2）のときだけ使う
+#if defined(_M_X64) || defined(__SSE2__)
+#define MINCLASS_SIMD 1
+#include <immintrin.h>
+#endif
+
+// ==============================
+//  配列版の SIMD 部品
+//   a と b を共通型 R へ変換しながら読み、比べて書くまでを1回の走査で行う。
+//   型の組ごとにコンパイル時に選ぶ（int32_t / float / double の組）
+//   比較は (ra < rb) ? ra : rb と同じ（minps / minpd も同じ定義なので、
+//   NaN を含むときも1組ずつの Min と同じ結果になる）
+// ==============================
+namespace min_mixed {
+
+// R のベクトル（比較と書き込み）
+template <class R> struct Ops;
+// T を Ops<R>::kLanes 個読んで R のベクトルにする
+template <class T, class R> struct Widen;
+
+// 変換して読める組だけ true
+template <class T, class R> inline constexpr bool kHasWiden = false;
+
+#if defined(MINCLASS_SIMD)
+#if defined(__AVX2__)
+template <> struct Ops<float> {
+  using V = __m256;
+  static constexpr size_t kLanes = 8;
+  static V Min(V a, V b) { return _mm256_min_ps(a, b); }
+  static void Store(float *p, V v) { _mm256_storeu_ps(p, v); }
+};
+template <> struct Ops<double> {
+  using V = __m256d;
+  static constexpr size_t kLanes = 4;
+  static V Min(V a, V b) { return _mm256_min_pd(a, b); }
+  static void Store(double *p, V v) { _mm256_storeu_pd(p, v); }
+};
+template <> struct Ops<std::int32_t> {
+  using V = __m256i;
+  static constexpr size_t kLanes = 8;
+  static V Min(V a, V b) { return _mm256_min_epi32(a, b); }
+  static void Store(std::int32_t *p, V v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+  }
+};
+
+template <> struct Widen<std::int32_t, std::int32_t> {
+  static __m256i Load(const std::int32_t *p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  }
+};
+template <> struct Widen<float, float> {
+  static __m256 Load(const float *p) { return _mm256_loadu_ps(p); }
+};
+template <> struct Widen<std::int32_t, float> {
+  static __m256 Load(const std::int32_t *p) {
+    return _mm256_cvtepi32_ps(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)));
+  }
+};
+template <> struct Widen<double, double> {
+  static __m256d Load(const double *p) { return _mm256_loadu_pd(p); }
+};
+template <> struct Widen<std::int32_t, double> {
+  static __m256d Load(const std::int32_t *p) {
+    return _mm256_cvtepi32_pd(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+  }
+};
+template <> struct Widen<float, double> {
+  static __m256d Load(const float *p) {
+    return _mm256_cvtps_pd(_mm_loadu_ps(p));
+  }
+};
+#else
+template <> struct Ops<float> {
+  using V = __m128;
+  static constexpr size_t kLanes = 4;
+  static V Min(V a, V b) { return _mm_min_ps(a, b); }
+  static void Store(float *p, V v) { _mm_storeu_ps(p, v); }
+};
+template <> struct Ops<double> {
+  using V = __m128d;
+  static constexpr size_t kLanes = 2;
+  static V Min(V a, V b) { return _mm_min_pd(a, b); }
+  static void Store(double *p, V v) { _mm_storeu_pd(p, v); }
+};
+template <> struct Ops<std::int32_t> {
+  using V = __m128i;
+  static constexpr size_t kLanes = 4;
+  static V Min(V a, V b) {
+#if defined(__SSE4_1__)
+    return _mm_min_epi32(a, b);
+#else
+    // SSE2 には 32bit 整数の min が無いので比較とマスクで選ぶ
+    const __m128i lt = _mm_cmplt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(lt, a), _mm_andnot_si128(lt, b));
+#endif
+  }
+  static void Store(std::int32_t *p, V v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+  }
+};
+
+template <> struct Widen<std::int32_t, std::int32_t> {
+  static __m128i Load(const std::int32_t *p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+  }
+};
+template <> struct Widen<float, float> {
+  static __m128 Load(const float *p) { return _mm_loadu_ps(p); }
+};
+template <> struct Widen<std::int32_t, float> {
+  static __m128 Load(const std::int32_t *p) {
+    return _mm_cvtepi32_ps(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+  }
+};
+template <> struct Widen<double, double> {
+  static __m128d Load(const double *p) { return _mm_loadu_pd(p); }
+};
+// double 2個分なので 64bit だけ読む
+template <> struct Widen<std::int32_t, double> {
+  static __m128d Load(const std::int32_t *p) {
+    return _mm_cvtepi32_pd(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p)));
+  }
+};
+template <> struct Widen<float, double> {
+  static __m128d Load(const float *p) {
+    return _mm_cvtps_pd(_mm_castsi128_ps(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p))));
+  }
+};
+#endif
+
+template <> inline constexpr bool kHasWiden<std::int32_t, std::int32_t> = true;
+template <> inline constexpr bool kHasWiden<float, float> = true;
+template <> inline constexpr bool kHasWiden<std::int32_t, float> = true;
+template <> inline constexpr bool kHasWiden<double, double> = true;
+template <> inline constexpr bool kHasWiden<std::int32_t, double> = true;
+template <> inline constexpr bool kHasWiden<float, double> = true;
+#endif
+
+// a も b も SIMD で R へ読めるか
+template <class T1, class T2, class R>
+inline constexpr bool kHasKernel = kHasWiden<T1, R> && kHasWiden<T2, R>;
+
+// out[i] = (R(a[i]) < R(b[i])) ? R(a[i]) : R(b[i]) を SIMD の幅ずつ。
+//  端数は呼び出し側で処理するので、処理した個数を返す
+template <class T1, class T2, class R>
+size_t Kernel(const T1 *a, const T2 *b, R *out, size_t n) {
+  using O = Ops<R>;
+  const size_t L = O::kLanes;
+  size_t i = 0;
+  for (; i + 2 * L <= n; i += 2 * L) {
+    O::Store(out + i, O::Min(Widen<T1, R>::Load(a + i),
+                             Widen<T2, R>::Load(b + i)));
+    O::Store(out + i + L, O::Min(Widen<T1, R>::Load(a + i + L),
+                                 Widen<T2, R>::Load(b + i + L)));
+  }
+  for (; i + L <= n; i += L)
+    O::Store(out + i, O::Min(Widen<T1, R>::Load(a + i),
+                             Widen<T2, R>::Load(b + i)));
+  return i;
+}
+
+} // namespace min_mixed
+
+template <class T1, class T2> class MinClass {
+public:
+  using Result = std::common_type_t<T1, T2>;
+
+  // 2つの引数の小さい方を返す
+  Result Min(T1 a, T2 b) const {
+    using R = Result;
+    R ra = static_cast<R>(a);
+    R rb = static_cast<R>(b);
+    return (ra < rb) ? ra : rb;
+  }
+
+  // 配列版: out[i] = Min(a[i], b[i])（a, b, out は同じ長さ）
+  //  int32_t / float / double の組は変換と比較を1回の SIMD 走査で行う。
+  //  それ以外の組は上の Min を1組ずつ呼ぶ
+  void Min(std::span<const T1> a, std::span<const T2> b,
+           std::span<Result> out) const {
+    assert(a.size() == out.size() && b.size() == out.size());
+    const size_t n = out.size();
+    size_t i = 0;
+    if constexpr (min_mixed::kHasKernel<T1, T2, Result>)
+      i = min_mixed::Kernel(a.data(), b.data(), out.data(), n);
+    for (; i < n; ++i)
+      out[i] = Min(a[i], b[i]);
+  }
+};
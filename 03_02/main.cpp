@@ -1,18 +1,76 @@
 #include <stdio.h>
-#include <type_traits> // std::common_type_t
-
-template <class T1, class T2> class MinClass {
-public:
-  // 2つの引数の小さい方を返す
-  std::common_type_t<T1, T2> Min(T1 a, T2 b) const {
-    using R = std::common_type_t<T1, T2>;
-    R ra = static_cast<R>(a);
-    R rb = static_cast<R>(b);
-    return (ra < rb) ? ra : rb;
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "MinClass.h"
+
+// ==============================
+//  配列版のベンチマーク
+//   使い方: 03_02.exe --bench
+//   1組ずつ Min を呼ぶループと SIMD 版を比べる（結果も照合する）
+// ==============================
+using BenchClock = std::chrono::steady_clock;
+
+template <class T> static std::vector<T> MakeSamples(size_t n, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> dist(-100000, 100000);
+  std::vector<T> v(n);
+  for (auto &x : v)
+    x = static_cast<T>(dist(rng)) / static_cast<T>(8);
+  return v;
+}
+
+template <class T1, class T2> static void BenchPair(const char *name) {
+  using R = typename MinClass<T1, T2>::Result;
+  const size_t kSamples = 4000000;
+  const int kFrames = 20;
+  const auto a = MakeSamples<T1>(kSamples, 1);
+  const auto b = MakeSamples<T2>(kSamples, 2);
+  std::vector<R> scalar(kSamples), simd(kSamples);
+  const MinClass<T1, T2> m;
+
+  auto t0 = BenchClock::now();
+  for (int f = 0; f < kFrames; ++f) {
+    for (size_t i = 0; i < kSamples; ++i)
+      scalar[i] = m.Min(a[i], b[i]);
   }
-};
+  const double scalarMs =
+      std::chrono::duration<double, std::milli>(BenchClock::now() - t0)
+          .count() /
+      kFrames;
 
-int main(void) {
+  t0 = BenchClock::now();
+  for (int f = 0; f < kFrames; ++f)
+    m.Min(a, b, simd);
+  const double simdMs =
+      std::chrono::duration<double, std::milli>(BenchClock::now() - t0)
+          .count() /
+      kFrames;
+
+  printf("%-16s %10.3f %10.3f %8.2fx%s\n", name, scalarMs, simdMs,
+         scalarMs / simdMs, scalar == simd ? "" : "  [mismatch]");
+}
+
+static void RunBenchmarks() {
+  printf("===== elementwise Min, 4M samples (ms / frame) =====\n");
+  printf("%-16s %10s %10s %9s\n", "pair", "scalar", "array", "speedup");
+  BenchPair<int, int>("int, int");
+  BenchPair<float, float>("float, float");
+  BenchPair<double, double>("double, double");
+  BenchPair<int, float>("int, float");
+  BenchPair<int, double>("int, double");
+  BenchPair<float, double>("float, double");
+  BenchPair<double, int>("double, int");
+}
+
+int main(int argc, char *argv[]) {
+  if (argc >= 2 && std::string(argv[1]) == "--bench") {
+    RunBenchmarks();
+    return 0;
+  }
 
   MinClass<int, int> m_ii;
   MinClass<float, float> m_ff;
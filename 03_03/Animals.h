@@ -0,0 +1,33 @@
+// Animals.h
+#pragma once
+
+#include <stdio.h>
+
+#include <string>
+
+// 基底クラス
+class Animal {
+public:
+  // 仮想関数
+  virtual void Speak() { printf("動物が鳴きます。\n"); }
+
+  // Speak と同じ文を、表示せずに out の後ろへ書く
+  virtual void SpeakTo(std::string &out) const { out += "動物が鳴きます。\n"; }
+
+  // 仮想デストラクタ
+  virtual ~Animal() {}
+};
+
+// 派生クラス：犬
+class Dog : public Animal {
+public:
+  void Speak() override { printf("犬：ワンワン\n"); }
+  void SpeakTo(std::string &out) const override { out += "犬：ワンワン\n"; }
+};
+
+// 派生クラス：猫
+class Cat : public Animal {
+public:
+  void Speak() override { printf("猫：ニャー\n"); }
+  void SpeakTo(std::string &out) const override { out += "猫：ニャー\n"; }
+};
@@ -0,0 +1,114 @@
+// DispatchBench.h
+#pragma once
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+// ==============================
+//  呼び出し方のベンチマークの枠（03_03 / 03_04 の --dispatch で共用）
+//   2種類の型が混ざった配列を、次の4通りで回して1個あたりの ns を比べる
+//   - virtual … 基底のポインタを並んだ順に仮想呼び出し
+//   - variant … 型を閉じた std::variant の配列を並んだ順に std::visit
+//   - crtp    … 型ごとの配列を CRTP の関数テンプレートで（インライン化される）
+//   - batched … 基底のポインタを型ごとに分け、型を指定して呼ぶ
+//   数と型の混ざり具合（Mixing）を振った表を出す。crtp と batched は
+//   型ごとに分けて持つので混ざり具合の影響を受けない
+//   1行分の用意と計測（何を呼ぶか）は各プロジェクトが row に書く
+// ==============================
+namespace dispatch_bench {
+
+using Clock = std::chrono::steady_clock;
+
+// sorted: 片方の型をすべて → もう片方をすべて
+// runs: kRun 個ずつ同じ型、shuffled: 1個ずつランダム
+enum class Mixing { Sorted, Runs, Shuffled };
+const size_t kRun = 64;
+
+inline const char *MixingName(Mixing mixing) {
+  switch (mixing) {
+  case Mixing::Sorted:
+    return "sorted";
+  case Mixing::Runs:
+    return "runs";
+  case Mixing::Shuffled:
+    return "shuffled";
+  }
+  return "?";
+}
+
+// ランダムな型の並びを混ざり具合に合わせて並べ直す（true の数は変えない）
+//   runs は kRun 個ずつの区切りの型を、その区切りの先頭の元の型で決める。
+//   その型が残り足りないときは残っている分で埋める（混ざる区切りは1つだけ）
+inline std::vector<bool> Arrange(std::vector<bool> kinds, Mixing mixing) {
+  size_t trues = 0;
+  for (size_t i = 0; i < kinds.size(); ++i)
+    trues += kinds[i];
+  if (mixing == Mixing::Sorted) {
+    for (size_t i = 0; i < kinds.size(); ++i)
+      kinds[i] = i < trues;
+  } else if (mixing == Mixing::Runs) {
+    size_t falses = kinds.size() - trues;
+    for (size_t begin = 0; begin < kinds.size(); begin += kRun) {
+      const size_t end = std::min(begin + kRun, kinds.size());
+      const size_t size = end - begin;
+      // 区切りに入れる true の数。足りなければ true から先に残りを並べる
+      size_t take = std::min(trues, size);
+      if (kinds[begin] ? trues >= size : falses >= size) // 書き換える前に読む
+        take = kinds[begin] ? size : 0;
+      for (size_t i = begin; i < end; ++i)
+        kinds[i] = i - begin < take;
+      trues -= take;
+      falses -= size - take;
+    }
+  }
+  return kinds;
+}
+
+// f()（1回で全部を回す）を reps 回繰り返し、1個あたりの ns を返す
+template <class F> double NsPerItem(size_t count, size_t reps, F f) {
+  const auto t0 = Clock::now();
+  for (size_t r = 0; r < reps; ++r)
+    f();
+  return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() /
+         (static_cast<double>(count) * reps);
+}
+
+// 1行分の結果（1個あたりの ns）
+struct Times {
+  double virtualNs = 0.0;
+  double variantNs = 0.0;
+  double crtpNs = 0.0;
+  double batchedNs = 0.0;
+};
+
+// 数 × 混ざり具合 の表を出す
+//   row(count, mixing, reps, times) が1行分を計り、4通りの結果が
+//   そろっていれば true を返す
+template <class Row>
+void Run(const char *title, const char *itemsLabel, Row row) {
+  const size_t kCounts[] = {size_t(1) << 10, size_t(1) << 14, size_t(1) << 18,
+                            size_t(1) << 22};
+  const Mixing kMixings[] = {Mixing::Sorted, Mixing::Runs, Mixing::Shuffled};
+  // 小さい配列でも計る時間がそろうよう、呼ぶ回数の合計を同じくらいにする
+  const size_t kCalls = size_t(1) << 24;
+
+  printf("===== %s =====\n", title);
+  printf("%10s %-9s %9s %9s %9s %9s\n", itemsLabel, "mixing", "virtual",
+         "variant", "crtp", "batched");
+  for (size_t count : kCounts) {
+    const size_t reps = count < kCalls ? kCalls / count : 1;
+    for (Mixing mixing : kMixings) {
+      Times t;
+      const bool ok = row(count, mixing, reps, t);
+      printf("%10zu %-9s %9.2f %9.2f %9.2f %9.2f%s\n", count,
+             MixingName(mixing), t.virtualNs, t.variantNs, t.crtpNs,
+             t.batchedNs, ok ? "" : "  [result mismatch]");
+    }
+  }
+}
+
+} // namespace dispatch_bench
@@ -0,0 +1,245 @@
+// ObjectPool.h
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ==============================
+//  プール・アリーナで作ったオブジェクトの持ち主
+//   unique_ptr と同じくムーブのみで、破棄するときに仮想デストラクタを
+//   呼んでから、メモリを作った側（ObjectReleaser）へ返す。
+//   PoolPtr<Dog> は PoolPtr<Animal> へムーブで変換できる
+//   作った側（プール・アリーナ）はすべての PoolPtr より長く生きること
+// ==============================
+class ObjectReleaser {
+public:
+  // mem はオブジェクトの先頭（破棄済み）
+  virtual void Release(void *mem) = 0;
+
+protected:
+  ~ObjectReleaser() = default;
+};
+
+template <class T> class PoolPtr {
+public:
+  PoolPtr() noexcept = default;
+  PoolPtr(std::nullptr_t) noexcept {}
+  PoolPtr(T *ptr, ObjectReleaser *owner) noexcept
+      : m_ptr(ptr), m_owner(owner) {}
+
+  PoolPtr(PoolPtr &&other) noexcept
+      : m_ptr(std::exchange(other.m_ptr, nullptr)), m_owner(other.m_owner) {}
+  template <class U,
+            class = std::enable_if_t<std::is_convertible<U *, T *>::value>>
+  PoolPtr(PoolPtr<U> &&other) noexcept
+      : m_ptr(std::exchange(other.m_ptr, nullptr)), m_owner(other.m_owner) {}
+
+  PoolPtr &operator=(PoolPtr &&other) noexcept {
+    if (this != &other) {
+      reset();
+      m_ptr = std::exchange(other.m_ptr, nullptr);
+      m_owner = other.m_owner;
+    }
+    return *this;
+  }
+  PoolPtr(const PoolPtr &) = delete;
+  PoolPtr &operator=(const PoolPtr &) = delete;
+  ~PoolPtr() { reset(); }
+
+  void reset() noexcept {
+    if (!m_ptr)
+      return;
+    // 基底クラスへのポインタでも、オブジェクト全体の先頭を返す
+    void *mem = MostDerived(m_ptr);
+    m_ptr->~T();
+    m_owner->Release(mem);
+    m_ptr = nullptr;
+  }
+
+  T *get() const noexcept { return m_ptr; }
+  T *operator->() const noexcept { return m_ptr; }
+  T &operator*() const noexcept { return *m_ptr; }
+  explicit operator bool() const noexcept { return m_ptr != nullptr; }
+
+private:
+  template <class U> friend class PoolPtr;
+
+  static void *MostDerived(T *p) {
+    if constexpr (std::is_polymorphic<T>::value)
+      return dynamic_cast<void *>(p);
+    else
+      return p;
+  }
+
+  T *m_ptr = nullptr;
+  ObjectReleaser *m_owner = nullptr;
+};
+
+// ==============================
+//  型ごとのプール
+//   T 1個分の枠を chunk 個ずつまとめて確保し、空いた枠は単方向リスト
+//   （枠の中にポインタを置く）でつなぐ。作る・捨てるは O(1) で、
+//   一般のヒープを通らない。スレッドからは同時に使わないこと
+// ==============================
+template <class T> class ObjectPool final : public ObjectReleaser {
+public:
+  explicit ObjectPool(size_t slotsPerChunk = 1024)
+      : m_slotsPerChunk(slotsPerChunk > 0 ? slotsPerChunk : 1) {}
+  ~ObjectPool() { assert(m_live == 0 && "PoolPtr がまだ残っています"); }
+  ObjectPool(const ObjectPool &) = delete;
+  ObjectPool &operator=(const ObjectPool &) = delete;
+
+  template <class... Args> PoolPtr<T> Make(Args &&...args) {
+    void *mem = Pop();
+    T *p;
+    try {
+      p = ::new (mem) T(std::forward<Args>(args)...);
+    } catch (...) {
+      Push(mem);
+      throw;
+    }
+    ++m_live;
+    return PoolPtr<T>(p, this);
+  }
+
+  void Release(void *mem) override {
+    Push(mem);
+    --m_live;
+  }
+
+  // 生きているオブジェクトの数
+  size_t live() const { return m_live; }
+  // 確保済みの枠の数
+  size_t capacity() const { return m_chunks.size() * m_slotsPerChunk; }
+
+private:
+  union Slot {
+    Slot *next;
+    alignas(T) unsigned char storage[sizeof(T)];
+  };
+
+  void *Pop() {
+    if (!m_free)
+      Grow();
+    Slot *slot = m_free;
+    m_free = slot->next;
+    return slot->storage;
+  }
+
+  void Push(void *mem) {
+    Slot *slot = static_cast<Slot *>(mem);
+    slot->next = m_free;
+    m_free = slot;
+  }
+
+  void Grow() {
+    std::unique_ptr<Slot[]> chunk(new Slot[m_slotsPerChunk]);
+    for (size_t i = m_slotsPerChunk; i-- > 0;)
+      Push(&chunk[i]);
+    m_chunks.push_back(std::move(chunk));
+  }
+
+  size_t m_slotsPerChunk;
+  Slot *m_free = nullptr;
+  size_t m_live = 0;
+  std::vector<std::unique_ptr<Slot[]>> m_chunks;
+};
+
+// ==============================
+//  派生クラスごとのプールの組
+//   PoolSet<Dog, Cat> pools;
+//   PoolPtr<Animal> a = pools.Make<Dog>();
+// ==============================
+template <class... Types> class PoolSet {
+public:
+  explicit PoolSet(size_t slotsPerChunk = 1024)
+      : m_pools(ChunkSize<Types>(slotsPerChunk)...) {}
+
+  template <class T, class... Args> PoolPtr<T> Make(Args &&...args) {
+    return pool<T>().Make(std::forward<Args>(args)...);
+  }
+
+  template <class T> ObjectPool<T> &pool() {
+    return std::get<ObjectPool<T>>(m_pools);
+  }
+
+private:
+  // 各プールに同じ値を渡すため（Types の数だけ展開する）
+  template <class> static size_t ChunkSize(size_t n) { return n; }
+
+  std::tuple<ObjectPool<Types>...> m_pools;
+};
+
+// ==============================
+//  フレーム単位のアリーナ
+//   ブロックの先頭から順に切り出すだけ（確保はポインタを進めるだけ）。
+//   個々の解放ではメモリは戻らず、Reset() でまとめて先頭に戻す。
+//   ブロックは捨てずに次のフレームで使い回す
+//   Reset() の前に、このアリーナの PoolPtr をすべて破棄しておくこと
+// ==============================
+class FrameArena final : public ObjectReleaser {
+public:
+  explicit FrameArena(size_t blockBytes = 64 * 1024)
+      : m_blockBytes(blockBytes) {}
+  ~FrameArena() { assert(m_live == 0 && "PoolPtr がまだ残っています"); }
+  FrameArena(const FrameArena &) = delete;
+  FrameArena &operator=(const FrameArena &) = delete;
+
+  template <class T, class... Args> PoolPtr<T> Make(Args &&...args) {
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "アラインメントが大きすぎます");
+    T *p = ::new (Allocate(sizeof(T), alignof(T)))
+        T(std::forward<Args>(args)...);
+    ++m_live;
+    return PoolPtr<T>(p, this);
+  }
+
+  void Release(void *) override { --m_live; }
+
+  // 全部を先頭に戻す
+  void Reset() {
+    assert(m_live == 0 && "PoolPtr がまだ残っています");
+    m_block = 0;
+    m_used = 0;
+  }
+
+  size_t live() const { return m_live; }
+
+private:
+  struct Block {
+    std::unique_ptr<unsigned char[]> data;
+    size_t size;
+  };
+
+  void *Allocate(size_t size, size_t align) {
+    for (;;) {
+      if (m_block < m_blocks.size()) {
+        const size_t offset = (m_used + align - 1) & ~(align - 1);
+        if (offset + size <= m_blocks[m_block].size) {
+          m_used = offset + size;
+          return m_blocks[m_block].data.get() + offset;
+        }
+        ++m_block; // 残りは捨てて次のブロックへ
+        m_used = 0;
+        continue;
+      }
+      // 使い回せるブロックが尽きたら足す（大きいものはそれ専用に）
+      const size_t bytes = size > m_blockBytes ? size : m_blockBytes;
+      m_blocks.push_back(Block{std::unique_ptr<unsigned char[]>(
+                                   new unsigned char[bytes]),
+                               bytes});
+    }
+  }
+
+  size_t m_blockBytes;
+  std::vector<Block> m_blocks;
+  size_t m_block = 0; // 今切り出しているブロック
+  size_t m_used = 0;  // そのブロックの使用済みバイト数
+  size_t m_live = 0;
+};
@@ -0,0 +1,100 @@
+// StaticAnimals.h
+#pragma once
+
+#include <stdio.h>
+
+#include <string>
+#include <typeinfo>
+#include <variant>
+#include <vector>
+
+#include "Animals.h"
+
+// ==============================
+//  仮想関数を使わない動物（静的ポリモーフィズム）
+//   Animals.h の Dog / Cat と同じ文を出すが、vtable を持たず
+//   呼び出し先はコンパイル時に決まる（インライン化できる）
+//   - Animal<Derived> … CRTP の基底。同じ型の配列を回す関数テンプレートで使う
+//   - AnyAnimal       … 型を閉じた std::variant。型の混ざった配列を値で持つ
+//  動物の種類を後から足すときは AnyAnimal にも足すこと
+// ==============================
+namespace static_animals {
+
+template <class Derived> class Animal {
+public:
+  void Speak() const { self().SpeakImpl(); }
+  void SpeakTo(std::string &out) const { self().SpeakToImpl(out); }
+
+protected:
+  // 派生クラスからだけ作れる。基底のまま持ったり消したりはさせない
+  Animal() = default;
+  ~Animal() = default;
+
+private:
+  const Derived &self() const { return static_cast<const Derived &>(*this); }
+};
+
+class Dog : public Animal<Dog> {
+private:
+  friend Animal<Dog>;
+  void SpeakImpl() const { printf("犬：ワンワン\n"); }
+  void SpeakToImpl(std::string &out) const { out += "犬：ワンワン\n"; }
+};
+
+class Cat : public Animal<Cat> {
+private:
+  friend Animal<Cat>;
+  void SpeakImpl() const { printf("猫：ニャー\n"); }
+  void SpeakToImpl(std::string &out) const { out += "猫：ニャー\n"; }
+};
+
+using AnyAnimal = std::variant<Dog, Cat>;
+
+inline void Speak(const AnyAnimal &a) {
+  std::visit([](const auto &animal) { animal.Speak(); }, a);
+}
+
+inline void SpeakTo(const AnyAnimal &a, std::string &out) {
+  std::visit([&out](const auto &animal) { animal.SpeakTo(out); }, a);
+}
+
+// 同じ型の動物をすべて鳴かせる（Derived ごとに別の関数になる）
+template <class Derived>
+void SpeakAllTo(const std::vector<Derived> &animals, std::string &out) {
+  for (const Animal<Derived> &a : animals)
+    a.SpeakTo(out);
+}
+
+} // namespace static_animals
+
+// ==============================
+//  Animal * を型ごとに分けたもの
+//   Animals.h の Dog / Cat はそのままで、ポインタを犬・猫の配列に振り分ける。
+//   鳴かせるときは d->Dog::SpeakTo と型を明示するので vtable を引かない。
+//   動物そのものは呼び出し元が持ったまま
+// ==============================
+struct AnimalBatches {
+  std::vector<const Dog *> dogs;
+  std::vector<const Cat *> cats;
+
+  // 実際の型が Dog / Cat ちょうどでなければ（派生クラスも）false
+  bool Add(const Animal *a) {
+    if (typeid(*a) == typeid(Dog)) {
+      dogs.push_back(static_cast<const Dog *>(a));
+      return true;
+    }
+    if (typeid(*a) == typeid(Cat)) {
+      cats.push_back(static_cast<const Cat *>(a));
+      return true;
+    }
+    return false;
+  }
+
+  // 犬をすべて → 猫をすべて（static_animals::SpeakAllTo を型ごとに呼ぶのと同じ順）
+  void SpeakTo(std::string &out) const {
+    for (const Dog *d : dogs)
+      d->Dog::SpeakTo(out);
+    for (const Cat *c : cats)
+      c->Cat::SpeakTo(out);
+  }
+};
@@ -1,28 +1,30 @@
 #include <stdio.h>
 
-// 基底クラス
-class Animal {
-public:
-  // 仮想関数
-  virtual void Speak() { printf("動物が鳴きます。\n"); }
-
-  // 仮想デストラクタ
-  virtual ~Animal() {}
-};
+#include <chrono>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
 
-// 派生クラス：犬
-class Dog : public Animal {
-public:
-  void Speak() override { printf("犬：ワンワン\n"); }
-};
+#include "Animals.h"
+#include "DispatchBench.h"
+#include "ObjectPool.h"
+#include "StaticAnimals.h"
 
-// 派生クラス：猫
-class Cat : public Animal {
-public:
-  void Speak() override { printf("猫：ニャー\n"); }
-};
+static void RunBenchmarks();
+static void RunDispatchBenchmarks();
+
+int main(int argc, char *argv[]) {
+  if (argc >= 2 && std::string(argv[1]) == "--bench") {
+    RunBenchmarks();
+    return 0;
+  }
+  if (argc >= 2 && std::string(argv[1]) == "--dispatch") {
+    RunDispatchBenchmarks();
+    return 0;
+  }
 
-int main(void) {
   // 基底クラスのポインタで派生クラスのインスタンスを扱う
   Animal *a1 = new Dog();
   Animal *a2 = new Cat();
@@ -36,3 +38,229 @@ int main(void) {
 
   return 0;
 }
+
+// ==============================
+//  ベンチマーク
+//   使い方: 03_03.exe --bench
+//   犬・猫を作っては捨てる速さ（作る+捨てるの組を1回と数える）を、
+//   new / delete、PoolSet・FrameArena、std::pmr で比べる
+//   - churn … 4096 体を生かしたまま、ランダムな1体を作り直し続ける
+//   - frame … 1フレームに 10000 体作り、フレームの終わりに全部捨てる
+// ==============================
+using BenchClock = std::chrono::steady_clock;
+
+// std::pmr の資源から作ったオブジェクトを Animal * のまま捨てる
+struct PmrDelete {
+  std::pmr::memory_resource *resource;
+  void operator()(Animal *p) const {
+    void *mem = dynamic_cast<void *>(p);
+    p->~Animal();
+    // Dog と Cat は同じ大きさ（static_assert で確認）
+    resource->deallocate(mem, sizeof(Dog), alignof(Dog));
+  }
+};
+static_assert(sizeof(Dog) == sizeof(Cat) && alignof(Dog) == alignof(Cat),
+              "PmrDelete は Dog と Cat が同じ大きさの前提");
+using PmrAnimal = std::unique_ptr<Animal, PmrDelete>;
+
+template <class T> static PmrAnimal MakePmr(std::pmr::memory_resource *r) {
+  void *mem = r->allocate(sizeof(T), alignof(T));
+  return PmrAnimal(::new (mem) T(), PmrDelete{r});
+}
+
+// 作る型の並び（true なら犬）
+static std::vector<bool> MakeKinds(size_t count) {
+  std::mt19937 rng(2025);
+  std::vector<bool> kinds(count);
+  for (size_t i = 0; i < count; ++i)
+    kinds[i] = (rng() & 1) != 0;
+  return kinds;
+}
+
+// 生きている window 体のうち slots[i] 番目を作り直す、を kinds の数だけ
+template <class Handle, class Make>
+static double BenchChurn(const std::vector<bool> &kinds,
+                         const std::vector<size_t> &slots, size_t window,
+                         Make make) {
+  std::vector<Handle> live(window);
+  for (size_t i = 0; i < window; ++i)
+    live[i] = make(kinds[i]);
+  const auto t0 = BenchClock::now();
+  for (size_t i = 0; i < kinds.size(); ++i) {
+    Handle &h = live[slots[i]];
+    h = nullptr;
+    h = make(kinds[i]);
+  }
+  return std::chrono::duration<double, std::nano>(BenchClock::now() - t0)
+             .count() /
+         kinds.size();
+}
+
+// perFrame 体作って全部捨てる、を frames 回。endFrame はフレームの終わりに
+template <class Handle, class Make, class EndFrame>
+static double BenchFrames(const std::vector<bool> &kinds, size_t perFrame,
+                          Make make, EndFrame endFrame) {
+  std::vector<Handle> frame;
+  frame.reserve(perFrame);
+  const size_t frames = kinds.size() / perFrame;
+  const auto t0 = BenchClock::now();
+  for (size_t f = 0; f < frames; ++f) {
+    for (size_t i = 0; i < perFrame; ++i)
+      frame.push_back(make(kinds[f * perFrame + i]));
+    frame.clear();
+    endFrame();
+  }
+  return std::chrono::duration<double, std::nano>(BenchClock::now() - t0)
+             .count() /
+         (frames * perFrame);
+}
+
+static void Report(const char *name, double ns, double baseline) {
+  printf("%-22s %8.2f %10.1f %7.2fx\n", name, ns, 1e3 / ns, baseline / ns);
+}
+
+static void RunBenchmarks() {
+  const size_t kOps = 10000000;
+  const size_t kWindow = 4096;
+  const size_t kPerFrame = 10000;
+  const std::vector<bool> kinds = MakeKinds(kOps);
+  std::vector<size_t> slots(kOps);
+  {
+    std::mt19937 rng(7);
+    for (auto &s : slots)
+      s = rng() % kWindow;
+  }
+
+  using Owned = std::unique_ptr<Animal>;
+  const auto makeNew = [](bool dog) -> Owned {
+    if (dog)
+      return Owned(new Dog());
+    return Owned(new Cat());
+  };
+  PoolSet<Dog, Cat> pools;
+  const auto makePool = [&pools](bool dog) -> PoolPtr<Animal> {
+    if (dog)
+      return pools.Make<Dog>();
+    return pools.Make<Cat>();
+  };
+
+  printf("===== churn: %zu live, %zu replacements =====\n", kWindow, kOps);
+  printf("%-22s %8s %10s %8s\n", "allocator", "ns/op", "M ops/s", "speedup");
+  const double churnNew = BenchChurn<Owned>(kinds, slots, kWindow, makeNew);
+  Report("new / delete", churnNew, churnNew);
+  Report("PoolSet",
+         BenchChurn<PoolPtr<Animal>>(kinds, slots, kWindow, makePool),
+         churnNew);
+  {
+    std::pmr::unsynchronized_pool_resource resource;
+    const auto makePmr = [&resource](bool dog) {
+      return dog ? MakePmr<Dog>(&resource) : MakePmr<Cat>(&resource);
+    };
+    Report("pmr unsync pool",
+           BenchChurn<PmrAnimal>(kinds, slots, kWindow, makePmr), churnNew);
+  }
+  {
+    std::pmr::synchronized_pool_resource resource;
+    const auto makePmr = [&resource](bool dog) {
+      return dog ? MakePmr<Dog>(&resource) : MakePmr<Cat>(&resource);
+    };
+    Report("pmr sync pool",
+           BenchChurn<PmrAnimal>(kinds, slots, kWindow, makePmr), churnNew);
+  }
+
+  printf("\n===== frame: %zu objects per frame =====\n", kPerFrame);
+  printf("%-22s %8s %10s %8s\n", "allocator", "ns/op", "M ops/s", "speedup");
+  const auto noop = [] {};
+  const double frameNew =
+      BenchFrames<Owned>(kinds, kPerFrame, makeNew, noop);
+  Report("new / delete", frameNew, frameNew);
+  Report("PoolSet",
+         BenchFrames<PoolPtr<Animal>>(kinds, kPerFrame, makePool, noop),
+         frameNew);
+  {
+    FrameArena arena;
+    const auto makeArena = [&arena](bool dog) -> PoolPtr<Animal> {
+      if (dog)
+        return arena.Make<Dog>();
+      return arena.Make<Cat>();
+    };
+    Report("FrameArena",
+           BenchFrames<PoolPtr<Animal>>(kinds, kPerFrame, makeArena,
+                                        [&arena] { arena.Reset(); }),
+           frameNew);
+  }
+  {
+    std::pmr::monotonic_buffer_resource resource;
+    const auto makePmr = [&resource](bool dog) {
+      return dog ? MakePmr<Dog>(&resource) : MakePmr<Cat>(&resource);
+    };
+    Report("pmr monotonic",
+           BenchFrames<PmrAnimal>(kinds, kPerFrame, makePmr,
+                                  [&resource] { resource.release(); }),
+           frameNew);
+  }
+}
+
+// ==============================
+//  呼び出し方のベンチマーク
+//   使い方: 03_03.exe --dispatch
+//   全員に SpeakTo で鳴かせて文字列に溜める（1体あたりの ns。表の枠は
+//   DispatchBench.h）。virtual は Animal *、variant は AnyAnimal、
+//   crtp は Dog / Cat の配列を SpeakAllTo で、batched は AnimalBatches
+// ==============================
+static bool RunDispatchRow(size_t count, dispatch_bench::Mixing mixing,
+                           size_t reps, dispatch_bench::Times &t) {
+  using dispatch_bench::NsPerItem;
+
+  const std::vector<bool> kinds =
+      dispatch_bench::Arrange(MakeKinds(count), mixing);
+  std::vector<std::unique_ptr<Animal>> animals;
+  std::vector<static_animals::AnyAnimal> variants;
+  std::vector<static_animals::Dog> dogs;
+  std::vector<static_animals::Cat> cats;
+  animals.reserve(count);
+  variants.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    if (kinds[i]) {
+      animals.emplace_back(new Dog());
+      variants.emplace_back(static_animals::Dog());
+      dogs.emplace_back();
+    } else {
+      animals.emplace_back(new Cat());
+      variants.emplace_back(static_animals::Cat());
+      cats.emplace_back();
+    }
+  }
+  AnimalBatches batches;
+  for (const auto &a : animals)
+    batches.Add(a.get());
+
+  std::string virtualOut, variantOut, crtpOut, batchedOut;
+  t.virtualNs = NsPerItem(count, reps, [&animals, &virtualOut] {
+    virtualOut.clear();
+    for (const auto &a : animals)
+      a->SpeakTo(virtualOut);
+  });
+  t.variantNs = NsPerItem(count, reps, [&variants, &variantOut] {
+    variantOut.clear();
+    for (const auto &a : variants)
+      static_animals::SpeakTo(a, variantOut);
+  });
+  t.crtpNs = NsPerItem(count, reps, [&dogs, &cats, &crtpOut] {
+    crtpOut.clear();
+    static_animals::SpeakAllTo(dogs, crtpOut);
+    static_animals::SpeakAllTo(cats, crtpOut);
+  });
+  t.batchedNs = NsPerItem(count, reps, [&batches, &batchedOut] {
+    batchedOut.clear();
+    batches.SpeakTo(batchedOut);
+  });
+
+  // 並んだ順に鳴かせるもの同士、型ごとに鳴かせるもの同士は同じ文字列になる
+  return variantOut == virtualOut && batchedOut == crtpOut &&
+         crtpOut.size() == virtualOut.size();
+}
+
+static void RunDispatchBenchmarks() {
+  dispatch_bench::Run("SpeakTo, ns/animal", "animals", RunDispatchRow);
+}
@@ -0,0 +1,184 @@
+// ShapeStore.h
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Shapes.h"
+
+// SSE2 は x64 なら常に使える。AVX は /arch:AVX（-mavx）以上のときだけ使う
+#if defined(_M_X64) || defined(__SSE2__)
+#define SHAPE_SIMD 1
+#include <immintrin.h>
+#endif
+
+// ==============================
+//  面積の計算をまとめて行う関数
+//   Sizes 系は要素ごとに Circle::Size / Rectangle::Size と同じ順で掛けるので
+//   結果はビット単位で一致する。Sum 系は4本に分けて足すので、
+//   順に足した場合とは丸めの分だけ違うことがある
+// ==============================
+namespace shape_kernels {
+
+// out[i] = π r[i]^2
+inline void CircleSizes(const double *radius, size_t n, double *out) {
+  size_t i = 0;
+#if defined(__AVX__)
+  const __m256d pi = _mm256_set1_pd(kPi);
+  for (; i + 4 <= n; i += 4) {
+    const __m256d r = _mm256_loadu_pd(radius + i);
+    _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_mul_pd(pi, r), r));
+  }
+#elif defined(SHAPE_SIMD)
+  const __m128d pi = _mm_set1_pd(kPi);
+  for (; i + 2 <= n; i += 2) {
+    const __m128d r = _mm_loadu_pd(radius + i);
+    _mm_storeu_pd(out + i, _mm_mul_pd(_mm_mul_pd(pi, r), r));
+  }
+#endif
+  for (; i < n; ++i)
+    out[i] = kPi * radius[i] * radius[i];
+}
+
+// out[i] = w[i] h[i]
+inline void RectangleSizes(const double *width, const double *height,
+                           size_t n, double *out) {
+  size_t i = 0;
+#if defined(__AVX__)
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(width + i),
+                                            _mm256_loadu_pd(height + i)));
+  }
+#elif defined(SHAPE_SIMD)
+  for (; i + 2 <= n; i += 2) {
+    const __m128d w = _mm_loadu_pd(width + i);
+    _mm_storeu_pd(out + i, _mm_mul_pd(w, _mm_loadu_pd(height + i)));
+  }
+#endif
+  for (; i < n; ++i)
+    out[i] = width[i] * height[i];
+}
+
+// Σ a[i] b[i]（円なら a = b = 半径で Σ r^2）
+inline double SumProducts(const double *a, const double *b, size_t n) {
+  size_t i = 0;
+  double sum = 0.0;
+#if defined(__AVX__)
+  __m256d acc[4] = {_mm256_setzero_pd(), _mm256_setzero_pd(),
+                    _mm256_setzero_pd(), _mm256_setzero_pd()};
+  for (; i + 16 <= n; i += 16) {
+    for (int k = 0; k < 4; ++k) {
+      const __m256d x = _mm256_loadu_pd(a + i + 4 * k);
+      const __m256d y = _mm256_loadu_pd(b + i + 4 * k);
+      acc[k] = _mm256_add_pd(acc[k], _mm256_mul_pd(x, y));
+    }
+  }
+  const __m256d s4 = _mm256_add_pd(_mm256_add_pd(acc[0], acc[1]),
+                                   _mm256_add_pd(acc[2], acc[3]));
+  const __m128d s2 = _mm_add_pd(_mm256_castpd256_pd128(s4),
+                                _mm256_extractf128_pd(s4, 1));
+  sum = _mm_cvtsd_f64(_mm_add_sd(s2, _mm_unpackhi_pd(s2, s2)));
+#elif defined(SHAPE_SIMD)
+  __m128d acc[4] = {_mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd(),
+                    _mm_setzero_pd()};
+  for (; i + 8 <= n; i += 8) {
+    for (int k = 0; k < 4; ++k) {
+      const __m128d x = _mm_loadu_pd(a + i + 2 * k);
+      const __m128d y = _mm_loadu_pd(b + i + 2 * k);
+      acc[k] = _mm_add_pd(acc[k], _mm_mul_pd(x, y));
+    }
+  }
+  const __m128d s2 =
+      _mm_add_pd(_mm_add_pd(acc[0], acc[1]), _mm_add_pd(acc[2], acc[3]));
+  sum = _mm_cvtsd_f64(_mm_add_sd(s2, _mm_unpackhi_pd(s2, s2)));
+#else
+  double acc[4] = {};
+  for (; i + 4 <= n; i += 4) {
+    for (int k = 0; k < 4; ++k)
+      acc[k] += a[i + k] * b[i + k];
+  }
+  sum = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+#endif
+  for (; i < n; ++i)
+    sum += a[i] * b[i];
+  return sum;
+}
+
+} // namespace shape_kernels
+
+// ==============================
+//  図形を型ごとの配列に分けて持つ入れ物
+//   IShape * の配列と違い、円は半径・中心の配列、長方形は幅・高さ・中心の
+//   配列（SoA）に詰めて置く。仮想関数もポインタの参照先も通らないので、
+//   面積の合計は連続したメモリを SIMD でなめるだけになる（中心は読まない）
+//   ForEach で IShape として1つずつ扱うこともできる
+//   （順番は「円をすべて → 長方形をすべて」で、追加した順ではない）
+// ==============================
+class ShapeStore {
+public:
+  void Reserve(size_t circles, size_t rectangles) {
+    m_radius.reserve(circles);
+    m_circleX.reserve(circles);
+    m_circleY.reserve(circles);
+    m_width.reserve(rectangles);
+    m_height.reserve(rectangles);
+    m_rectangleX.reserve(rectangles);
+    m_rectangleY.reserve(rectangles);
+  }
+
+  void Add(const Circle &c) {
+    m_radius.push_back(c.radius());
+    m_circleX.push_back(c.center().x);
+    m_circleY.push_back(c.center().y);
+  }
+  void Add(const Rectangle &r) {
+    m_width.push_back(r.width());
+    m_height.push_back(r.height());
+    m_rectangleX.push_back(r.center().x);
+    m_rectangleY.push_back(r.center().y);
+  }
+
+  size_t size() const { return circleCount() + rectangleCount(); }
+  size_t circleCount() const { return m_radius.size(); }
+  size_t rectangleCount() const { return m_width.size(); }
+
+  // 面積の合計（π Σ r^2 + Σ w h）
+  double TotalArea() const {
+    return kPi * shape_kernels::SumProducts(m_radius.data(), m_radius.data(),
+                                            m_radius.size()) +
+           shape_kernels::SumProducts(m_width.data(), m_height.data(),
+                                      m_width.size());
+  }
+
+  // 円の面積を out へ（circleCount() 個）
+  void CircleSizes(double *out) const {
+    shape_kernels::CircleSizes(m_radius.data(), m_radius.size(), out);
+  }
+  // 長方形の面積を out へ（rectangleCount() 個）
+  void RectangleSizes(double *out) const {
+    shape_kernels::RectangleSizes(m_width.data(), m_height.data(),
+                                  m_width.size(), out);
+  }
+
+  // f(const IShape &) を図形ごとに呼ぶ（一時オブジェクトなので保持しないこと）
+  template <class F> void ForEach(F &&f) const {
+    for (size_t i = 0; i < m_radius.size(); ++i) {
+      const Circle c(m_radius[i], Point{m_circleX[i], m_circleY[i]});
+      f(static_cast<const IShape &>(c));
+    }
+    for (size_t i = 0; i < m_width.size(); ++i) {
+      const Rectangle rect(m_width[i], m_height[i],
+                           Point{m_rectangleX[i], m_rectangleY[i]});
+      f(static_cast<const IShape &>(rect));
+    }
+  }
+
+private:
+  std::vector<double> m_radius;
+  std::vector<double> m_circleX; // 円の中心
+  std::vector<double> m_circleY;
+  std::vector<double> m_width;
+  std::vector<double> m_height;
+  std::vector<double> m_rectangleX; // 長方形の中心
+  std::vector<double> m_rectangleY;
+};
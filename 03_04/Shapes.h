@@ -0,0 +1,130 @@
+// Shapes.h
+#pragma once
+
+#include <stdio.h>
+
+// ------------------------------
+// 位置と、軸に平行な外接矩形（AABB）
+// ------------------------------
+struct Point {
+  double x;
+  double y;
+};
+
+struct Aabb {
+  double minX;
+  double minY;
+  double maxX;
+  double maxY;
+
+  // 辺が接しているだけでも重なるとみなす
+  bool Overlaps(const Aabb &o) const {
+    return minX <= o.maxX && o.minX <= maxX && minY <= o.maxY &&
+           o.minY <= maxY;
+  }
+  bool Contains(const Aabb &o) const {
+    return minX <= o.minX && o.maxX <= maxX && minY <= o.minY &&
+           o.maxY <= maxY;
+  }
+  bool Contains(Point p) const {
+    return minX <= p.x && p.x <= maxX && minY <= p.y && p.y <= maxY;
+  }
+
+  double width() const { return maxX - minX; }
+  double height() const { return maxY - minY; }
+};
+
+// o を含むように広げる
+inline Aabb Merge(const Aabb &a, const Aabb &o) {
+  return Aabb{a.minX < o.minX ? a.minX : o.minX,
+              a.minY < o.minY ? a.minY : o.minY,
+              a.maxX > o.maxX ? a.maxX : o.maxX,
+              a.maxY > o.maxY ? a.maxY : o.maxY};
+}
+
+// ------------------------------
+// 抽象クラス
+// ------------------------------
+class IShape {
+public:
+  // 面積を返す
+  virtual double Size() const = 0;
+
+  // 図形を表示する
+  virtual void Draw() const = 0;
+
+  // 外接矩形を返す
+  virtual Aabb Bounds() const = 0;
+
+  // 点 p が図形の内側（境界を含む）にあるか
+  virtual bool Contains(Point p) const = 0;
+
+  virtual ~IShape() {}
+};
+
+// 円周率（Circle と、まとめて計算する側で同じ値を使う）
+const double kPi = 3.14159265358979323846;
+
+// ------------------------------
+// Circle（円）
+// ------------------------------
+class Circle : public IShape {
+public:
+  // center は円の中心
+  explicit Circle(double r, Point center = Point{0.0, 0.0})
+      : m_radius(r), m_center(center) {}
+
+  double Size() const override { return kPi * m_radius * m_radius; }
+
+  void Draw() const override { printf("Circle (radius=%.2f)\n", m_radius); }
+
+  Aabb Bounds() const override {
+    return Aabb{m_center.x - m_radius, m_center.y - m_radius,
+                m_center.x + m_radius, m_center.y + m_radius};
+  }
+
+  bool Contains(Point p) const override {
+    const double dx = p.x - m_center.x;
+    const double dy = p.y - m_center.y;
+    return dx * dx + dy * dy <= m_radius * m_radius;
+  }
+
+  double radius() const { return m_radius; }
+  Point center() const { return m_center; }
+
+private:
+  double m_radius;
+  Point m_center;
+};
+
+// ------------------------------
+// Rectangle（長方形）
+// ------------------------------
+class Rectangle : public IShape {
+public:
+  // center は長方形の中心（辺は軸に平行）
+  Rectangle(double w, double h, Point center = Point{0.0, 0.0})
+      : m_width(w), m_height(h), m_center(center) {}
+
+  double Size() const override { return m_width * m_height; }
+
+  void Draw() const override {
+    printf("Rectangle (width=%.2f, height=%.2f)\n", m_width, m_height);
+  }
+
+  Aabb Bounds() const override {
+    return Aabb{m_center.x - m_width / 2, m_center.y - m_height / 2,
+                m_center.x + m_width / 2, m_center.y + m_height / 2};
+  }
+
+  bool Contains(Point p) const override { return Bounds().Contains(p); }
+
+  double width() const { return m_width; }
+  double height() const { return m_height; }
+  Point center() const { return m_center; }
+
+private:
+  double m_width;
+  double m_height;
+  Point m_center;
+};
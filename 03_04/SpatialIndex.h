@@ -0,0 +1,453 @@
+// SpatialIndex.h
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Shapes.h"
+
+// ==============================
+//  位置を持つ図形の空間索引
+//   ShapeBvh（境界ボリューム階層）と ShapeGrid（一様格子）は同じ問い合わせに
+//   答える。どちらも作るときに図形をまとめて渡し、後から足すことはできない
+//   （図形は索引より長く生き、動かさないこと）
+//   - Query(region, f)      … 外接矩形が region と重なる図形ごとに f(shape)
+//   - QueryPoint(p, f)      … p を含む（IShape::Contains）図形ごとに f(shape)
+//   - AreaInside(region)    … 外接矩形が region にすっぽり入る図形の面積の合計
+//  f の呼ばれる順番は決まっていない
+// ==============================
+namespace spatial_detail {
+
+// 索引に入れる1図形（外接矩形と面積は作るときに1度だけ求める）
+struct Item {
+  Aabb bounds;
+  double size;
+  const IShape *shape;
+};
+
+inline std::vector<Item> MakeItems(const std::vector<const IShape *> &shapes) {
+  std::vector<Item> items;
+  items.reserve(shapes.size());
+  for (const IShape *s : shapes)
+    items.push_back(Item{s->Bounds(), s->Size(), s});
+  return items;
+}
+
+// SAH で使う「表面積」（2次元なので周の長さの半分）
+inline double HalfPerimeter(const Aabb &b) { return b.width() + b.height(); }
+
+inline Point Centroid(const Aabb &b) {
+  return Point{(b.minX + b.maxX) / 2, (b.minY + b.maxY) / 2};
+}
+
+inline double Axis(Point p, int axis) { return axis == 0 ? p.x : p.y; }
+
+} // namespace spatial_detail
+
+// ==============================
+//  BVH（境界ボリューム階層）
+//   中心の位置で 16 個の箱に分け、箱の境目のうち SAH（子の周の長さ ×
+//   図形の数の和）が最小のところで2つに割る（binned SAH）。
+//   葉は4個以下。ノードは深さ優先の順に1本の配列に並べ、左の子は
+//   すぐ後ろ、右の子は添字で持つ。各ノードは下にある図形の面積の合計も持つので、
+//   region にすっぽり入るノードは潜らずに足せる
+//   大きさのばらついた図形でも性能が落ちにくい
+// ==============================
+class ShapeBvh {
+public:
+  explicit ShapeBvh(const std::vector<const IShape *> &shapes)
+      : m_items(spatial_detail::MakeItems(shapes)) {
+    if (m_items.empty())
+      return;
+    m_nodes.reserve(2 * m_items.size() / kLeafSize + 1);
+    Build(0, static_cast<uint32_t>(m_items.size()), 0);
+  }
+
+  size_t size() const { return m_items.size(); }
+  size_t nodeCount() const { return m_nodes.size(); }
+
+  template <class F> void Query(const Aabb &region, F &&f) const {
+    ForEachOverlap(region, [&](const spatial_detail::Item &item) {
+      if (item.bounds.Overlaps(region))
+        f(*item.shape);
+    });
+  }
+
+  template <class F> void QueryPoint(Point p, F &&f) const {
+    ForEachOverlap(Aabb{p.x, p.y, p.x, p.y},
+                   [&](const spatial_detail::Item &item) {
+                     if (item.bounds.Contains(p) && item.shape->Contains(p))
+                       f(*item.shape);
+                   });
+  }
+
+  double AreaInside(const Aabb &region) const {
+    double total = 0.0;
+    if (m_nodes.empty())
+      return total;
+    uint32_t stack[kStackSize];
+    size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+      const uint32_t index = stack[--top];
+      const Node &node = m_nodes[index];
+      if (!node.bounds.Overlaps(region))
+        continue;
+      if (region.Contains(node.bounds)) {
+        total += node.area;
+        continue;
+      }
+      if (node.count > 0) {
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+          if (region.Contains(m_items[i].bounds))
+            total += m_items[i].size;
+        }
+        continue;
+      }
+      stack[top++] = node.first;
+      stack[top++] = index + 1;
+    }
+    return total;
+  }
+
+private:
+  static constexpr uint32_t kLeafSize = 4;
+  static constexpr int kBins = 16;
+  // これより深いところは中央値で割る（深さを抑え、探索のスタックに収める）
+  static constexpr int kMaxSahDepth = 48;
+  static constexpr size_t kStackSize = 128;
+
+  // count > 0 なら葉（m_items[first, first + count)）、
+  // 0 なら内部ノード（左の子はすぐ後ろ、右の子は m_nodes[first]）
+  struct Node {
+    Aabb bounds;
+    double area;
+    uint32_t first;
+    uint32_t count;
+  };
+
+  template <class F> void ForEachOverlap(const Aabb &region, F &&f) const {
+    if (m_nodes.empty())
+      return;
+    uint32_t stack[kStackSize];
+    size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+      const uint32_t index = stack[--top];
+      const Node &node = m_nodes[index];
+      if (!node.bounds.Overlaps(region))
+        continue;
+      if (node.count > 0) {
+        for (uint32_t i = node.first; i < node.first + node.count; ++i)
+          f(m_items[i]);
+        continue;
+      }
+      stack[top++] = node.first;
+      stack[top++] = index + 1;
+    }
+  }
+
+  // m_items[begin, end) のノードを作り、その添字を返す
+  uint32_t Build(uint32_t begin, uint32_t end, int depth) {
+    using spatial_detail::Axis;
+    using spatial_detail::Centroid;
+
+    const uint32_t index = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back(Node{m_items[begin].bounds, 0.0, begin, end - begin});
+    Aabb bounds = m_items[begin].bounds;
+    const Point c0 = Centroid(bounds);
+    Aabb centroids{c0.x, c0.y, c0.x, c0.y};
+    double area = 0.0;
+    for (uint32_t i = begin; i < end; ++i) {
+      bounds = Merge(bounds, m_items[i].bounds);
+      const Point c = Centroid(m_items[i].bounds);
+      centroids = Merge(centroids, Aabb{c.x, c.y, c.x, c.y});
+      area += m_items[i].size;
+    }
+    m_nodes[index].bounds = bounds;
+    m_nodes[index].area = area;
+    if (end - begin <= kLeafSize)
+      return index;
+
+    const int axis = centroids.width() >= centroids.height() ? 0 : 1;
+    const double lo = axis == 0 ? centroids.minX : centroids.minY;
+    const double extent = axis == 0 ? centroids.width() : centroids.height();
+    uint32_t mid = begin + (end - begin) / 2;
+    if (extent > 0.0 && depth < kMaxSahDepth) {
+      const double scale = kBins / extent;
+      const auto binOf = [&](const spatial_detail::Item &item) {
+        const int bin =
+            static_cast<int>((Axis(Centroid(item.bounds), axis) - lo) * scale);
+        return bin < kBins - 1 ? bin : kBins - 1;
+      };
+      uint32_t counts[kBins] = {};
+      Aabb boxes[kBins];
+      for (uint32_t i = begin; i < end; ++i) {
+        const int bin = binOf(m_items[i]);
+        boxes[bin] = counts[bin]++ == 0 ? m_items[i].bounds
+                                        : Merge(boxes[bin], m_items[i].bounds);
+      }
+      // 右から累積した「境目 b より右」の SAH 項
+      double rightCost[kBins] = {};
+      uint32_t rightCount = 0;
+      Aabb rightBox{};
+      for (int b = kBins - 1; b > 0; --b) {
+        if (counts[b] > 0) {
+          rightBox = rightCount == 0 ? boxes[b] : Merge(rightBox, boxes[b]);
+          rightCount += counts[b];
+        }
+        rightCost[b] = rightCount * spatial_detail::HalfPerimeter(rightBox);
+      }
+      int best = -1;
+      double bestCost = 0.0;
+      uint32_t leftCount = 0;
+      Aabb leftBox{};
+      for (int b = 0; b < kBins - 1; ++b) {
+        if (counts[b] > 0) {
+          leftBox = leftCount == 0 ? boxes[b] : Merge(leftBox, boxes[b]);
+          leftCount += counts[b];
+        }
+        // どちらかが空になる割り方は選ばない
+        if (leftCount == 0 || leftCount == end - begin)
+          continue;
+        const double cost =
+            leftCount * spatial_detail::HalfPerimeter(leftBox) +
+            rightCost[b + 1];
+        if (best < 0 || cost < bestCost) {
+          best = b;
+          bestCost = cost;
+        }
+      }
+      mid = static_cast<uint32_t>(
+          std::partition(m_items.begin() + begin, m_items.begin() + end,
+                         [&](const spatial_detail::Item &item) {
+                           return binOf(item) <= best;
+                         }) -
+          m_items.begin());
+    } else {
+      // 中心が1点に集まっている、または深くなりすぎた
+      std::nth_element(m_items.begin() + begin, m_items.begin() + mid,
+                       m_items.begin() + end,
+                       [axis](const spatial_detail::Item &a,
+                              const spatial_detail::Item &b) {
+                         return Axis(Centroid(a.bounds), axis) <
+                                Axis(Centroid(b.bounds), axis);
+                       });
+    }
+
+    Build(begin, mid, depth + 1);
+    const uint32_t right = Build(mid, end, depth + 1);
+    m_nodes[index].first = right;
+    m_nodes[index].count = 0;
+    return index;
+  }
+
+  std::vector<spatial_detail::Item> m_items;
+  std::vector<Node> m_nodes;
+};
+
+// ==============================
+//  一様格子
+//   全体を同じ大きさのマスに割り、図形は外接矩形が重なるマスすべてに
+//   登録する（マスごとの図形の添字は1本の配列に詰めて持つ）。
+//   複数のマスにまたがる図形は、問い合わせの範囲で最初に当たるマス
+//   （外接矩形と region の左下の大きい方）でだけ数える
+//   1つのマスに収まる図形の面積はマスごとに合計しておき、region に
+//   すっぽり入るマスはその合計を足すだけにする
+//   図形の大きさがそろっていると BVH より速いが、大きい図形が混ざると
+//   多くのマスに登録されて遅く・大きくなる
+// ==============================
+class ShapeGrid {
+public:
+  // cellSize が 0 以下なら、図形の大きさと密度から決める
+  explicit ShapeGrid(const std::vector<const IShape *> &shapes,
+                     double cellSize = 0.0)
+      : m_items(spatial_detail::MakeItems(shapes)) {
+    const size_t n = m_items.size();
+    m_domain = Aabb{0.0, 0.0, 0.0, 0.0};
+    double extent = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+      const Aabb &b = m_items[i].bounds;
+      m_domain = i == 0 ? b : Merge(m_domain, b);
+      extent += std::max(b.width(), b.height());
+    }
+    if (cellSize <= 0.0 && n > 0) {
+      // 1マスに平均4個くらい、かつ図形の大きさの2倍以上（またがる図形を
+      // 減らす）。小さくすると点の問い合わせは速くなるが、広い範囲の
+      // 問い合わせでなめるマスが増える
+      cellSize = std::max(2 * extent / n, std::sqrt(4 * m_domain.width() *
+                                                    m_domain.height() / n));
+    }
+    if (!(cellSize > 0.0))
+      cellSize = 1.0;
+    // マスの数は図形の数の4倍まで
+    for (;;) {
+      const double nx = std::floor(m_domain.width() / cellSize) + 1;
+      const double ny = std::floor(m_domain.height() / cellSize) + 1;
+      if (nx * ny <= 4.0 * n + 1) {
+        m_nx = static_cast<int>(nx);
+        m_ny = static_cast<int>(ny);
+        break;
+      }
+      cellSize *= 2;
+    }
+    m_cellSize = cellSize;
+    m_invCell = 1.0 / cellSize;
+
+    const size_t cells = static_cast<size_t>(m_nx) * m_ny;
+    m_cellStart.assign(cells + 1, 0);
+    SortByCell();
+    m_cellSpanning.assign(cells, 0);
+    m_localArea.assign(cells, 0.0);
+    for (const spatial_detail::Item &item : m_items) {
+      const CellRange r = Cells(item.bounds);
+      for (int y = r.y0; y <= r.y1; ++y) {
+        for (int x = r.x0; x <= r.x1; ++x)
+          ++m_cellStart[Cell(x, y) + 1];
+      }
+    }
+    for (size_t c = 0; c < cells; ++c)
+      m_cellStart[c + 1] += m_cellStart[c];
+    // 各マスの中では、またがる図形を前に、1マスに収まる図形を後ろに置く
+    std::vector<uint32_t> fill(m_cellStart.begin(), m_cellStart.end() - 1);
+    m_cellItems.resize(m_cellStart[cells]);
+    for (int pass = 0; pass < 2; ++pass) {
+      for (size_t i = 0; i < n; ++i) {
+        const CellRange r = Cells(m_items[i].bounds);
+        const bool local = r.x0 == r.x1 && r.y0 == r.y1;
+        if (local != (pass == 1))
+          continue;
+        for (int y = r.y0; y <= r.y1; ++y) {
+          for (int x = r.x0; x <= r.x1; ++x) {
+            const size_t c = Cell(x, y);
+            m_cellItems[fill[c]++] = static_cast<uint32_t>(i);
+            if (local)
+              m_localArea[c] += m_items[i].size;
+            else
+              ++m_cellSpanning[c];
+          }
+        }
+      }
+    }
+  }
+
+  size_t size() const { return m_items.size(); }
+  size_t cellCount() const { return m_localArea.size(); }
+  double cellSize() const { return m_cellSize; }
+
+  template <class F> void Query(const Aabb &region, F &&f) const {
+    if (m_items.empty() || !region.Overlaps(m_domain))
+      return;
+    const CellRange q = Cells(region);
+    for (int y = q.y0; y <= q.y1; ++y) {
+      for (int x = q.x0; x <= q.x1; ++x) {
+        const size_t c = Cell(x, y);
+        for (uint32_t k = m_cellStart[c]; k < m_cellStart[c + 1]; ++k) {
+          const spatial_detail::Item &item = m_items[m_cellItems[k]];
+          if (item.bounds.Overlaps(region) && FirstCell(item, q, x, y))
+            f(*item.shape);
+        }
+      }
+    }
+  }
+
+  template <class F> void QueryPoint(Point p, F &&f) const {
+    if (m_items.empty() || !m_domain.Contains(p))
+      return;
+    const size_t c = Cell(CellX(p.x), CellY(p.y));
+    for (uint32_t k = m_cellStart[c]; k < m_cellStart[c + 1]; ++k) {
+      const spatial_detail::Item &item = m_items[m_cellItems[k]];
+      if (item.bounds.Contains(p) && item.shape->Contains(p))
+        f(*item.shape);
+    }
+  }
+
+  double AreaInside(const Aabb &region) const {
+    double total = 0.0;
+    if (m_items.empty() || !region.Overlaps(m_domain))
+      return total;
+    const CellRange q = Cells(region);
+    for (int y = q.y0; y <= q.y1; ++y) {
+      for (int x = q.x0; x <= q.x1; ++x) {
+        const size_t c = Cell(x, y);
+        uint32_t end = m_cellStart[c + 1];
+        if (region.Contains(CellBounds(x, y))) {
+          // 1マスに収まる図形はすべて region の中
+          total += m_localArea[c];
+          end = m_cellStart[c] + m_cellSpanning[c];
+        }
+        for (uint32_t k = m_cellStart[c]; k < end; ++k) {
+          const spatial_detail::Item &item = m_items[m_cellItems[k]];
+          if (region.Contains(item.bounds) && FirstCell(item, q, x, y))
+            total += item.size;
+        }
+      }
+    }
+    return total;
+  }
+
+private:
+  struct CellRange {
+    int x0, y0, x1, y1;
+  };
+
+  // 範囲の外は端のマスにする（int に直す前に丸めて、あふれないように）
+  int CellX(double x) const {
+    const double cx = (x - m_domain.minX) * m_invCell;
+    return cx <= 0.0 ? 0 : (cx >= m_nx - 1 ? m_nx - 1 : static_cast<int>(cx));
+  }
+  int CellY(double y) const {
+    const double cy = (y - m_domain.minY) * m_invCell;
+    return cy <= 0.0 ? 0 : (cy >= m_ny - 1 ? m_ny - 1 : static_cast<int>(cy));
+  }
+  size_t Cell(int x, int y) const {
+    return static_cast<size_t>(y) * m_nx + x;
+  }
+  CellRange Cells(const Aabb &b) const {
+    return CellRange{CellX(b.minX), CellY(b.minY), CellX(b.maxX),
+                     CellY(b.maxY)};
+  }
+  Aabb CellBounds(int x, int y) const {
+    return Aabb{m_domain.minX + x * m_cellSize, m_domain.minY + y * m_cellSize,
+                m_domain.minX + (x + 1) * m_cellSize,
+                m_domain.minY + (y + 1) * m_cellSize};
+  }
+
+  // 図形を左下の角のあるマスの順に並べ替える（近い図形をメモリでも近くに
+  // 置き、問い合わせで図形を読むときのキャッシュミスを減らす）
+  void SortByCell() {
+    std::vector<uint32_t> start(m_cellStart.size(), 0);
+    for (const spatial_detail::Item &item : m_items)
+      ++start[CellOf(item) + 1];
+    for (size_t c = 0; c + 1 < start.size(); ++c)
+      start[c + 1] += start[c];
+    std::vector<spatial_detail::Item> sorted(m_items.size());
+    for (const spatial_detail::Item &item : m_items)
+      sorted[start[CellOf(item)]++] = item;
+    m_items.swap(sorted);
+  }
+  size_t CellOf(const spatial_detail::Item &item) const {
+    return Cell(CellX(item.bounds.minX), CellY(item.bounds.minY));
+  }
+
+  // マス (x, y) が、範囲 q の中でこの図形に最初に当たるマスか
+  bool FirstCell(const spatial_detail::Item &item, const CellRange &q, int x,
+                 int y) const {
+    const CellRange r = Cells(item.bounds);
+    return x == std::max(r.x0, q.x0) && y == std::max(r.y0, q.y0);
+  }
+
+  std::vector<spatial_detail::Item> m_items;
+  Aabb m_domain;
+  double m_cellSize = 1.0;
+  double m_invCell = 1.0;
+  int m_nx = 1;
+  int m_ny = 1;
+  std::vector<uint32_t> m_cellStart;    // マス c の図形は [c], [c + 1] の間
+  std::vector<uint32_t> m_cellSpanning; // そのうち先頭の何個がまたがる図形か
+  std::vector<uint32_t> m_cellItems;    // m_items の添字
+  std::vector<double> m_localArea;      // 1マスに収まる図形の面積の合計
+};
@@ -0,0 +1,124 @@
+// StaticShapes.h
+#pragma once
+
+#include <stdio.h>
+
+#include <typeinfo>
+#include <variant>
+#include <vector>
+
+#include "Shapes.h"
+
+// ==============================
+//  仮想関数を使わない図形（静的ポリモーフィズム）
+//   Shapes.h の Circle / Rectangle と同じ計算・表示をするが、vtable を持たず
+//   呼び出し先はコンパイル時に決まる（インライン化・ベクトル化できる）
+//   - Shape<Derived> … CRTP の基底。同じ型の配列を回す関数テンプレートで使う
+//   - AnyShape       … 型を閉じた std::variant。型の混ざった配列を値で持つ
+//  図形の種類を後から足すときは AnyShape にも足すこと（visit が網羅を確認する）
+// ==============================
+namespace static_shapes {
+
+template <class Derived> class Shape {
+public:
+  // 面積を返す
+  double Size() const { return self().SizeImpl(); }
+
+  // 図形を表示する
+  void Draw() const { self().DrawImpl(); }
+
+protected:
+  // Shape<Derived> だけを持つことはない（スライスを防ぐ）
+  Shape() = default;
+  ~Shape() = default;
+
+private:
+  const Derived &self() const { return static_cast<const Derived &>(*this); }
+};
+
+class Circle : public Shape<Circle> {
+public:
+  explicit Circle(double r) : m_radius(r) {}
+
+  double radius() const { return m_radius; }
+
+private:
+  friend Shape<Circle>;
+  double SizeImpl() const { return kPi * m_radius * m_radius; }
+  void DrawImpl() const { printf("Circle (radius=%.2f)\n", m_radius); }
+
+  double m_radius;
+};
+
+class Rectangle : public Shape<Rectangle> {
+public:
+  Rectangle(double w, double h) : m_width(w), m_height(h) {}
+
+  double width() const { return m_width; }
+  double height() const { return m_height; }
+
+private:
+  friend Shape<Rectangle>;
+  double SizeImpl() const { return m_width * m_height; }
+  void DrawImpl() const {
+    printf("Rectangle (width=%.2f, height=%.2f)\n", m_width, m_height);
+  }
+
+  double m_width;
+  double m_height;
+};
+
+using AnyShape = std::variant<Circle, Rectangle>;
+
+inline double Size(const AnyShape &s) {
+  return std::visit([](const auto &shape) { return shape.Size(); }, s);
+}
+
+inline void Draw(const AnyShape &s) {
+  std::visit([](const auto &shape) { shape.Draw(); }, s);
+}
+
+// 同じ型の図形の面積の合計（Derived ごとに別の関数になる）
+template <class Derived>
+double TotalSize(const std::vector<Derived> &shapes) {
+  double total = 0.0;
+  for (const Shape<Derived> &s : shapes)
+    total += s.Size();
+  return total;
+}
+
+} // namespace static_shapes
+
+// ==============================
+//  IShape * を型ごとに分けたもの
+//   既存の仮想関数のクラスのまま、型で並べ替えてまとめて回すための入れ物。
+//   型ごとの配列では Circle::Size() のように型を指定して呼ぶので、
+//   仮想呼び出しにならない。オブジェクトは元の場所のまま（コピーしない）
+// ==============================
+struct ShapeBatches {
+  std::vector<const Circle *> circles;
+  std::vector<const Rectangle *> rectangles;
+
+  // 実際の型が Circle / Rectangle ちょうどでなければ（派生クラスも）false
+  bool Add(const IShape *s) {
+    if (typeid(*s) == typeid(Circle)) {
+      circles.push_back(static_cast<const Circle *>(s));
+      return true;
+    }
+    if (typeid(*s) == typeid(Rectangle)) {
+      rectangles.push_back(static_cast<const Rectangle *>(s));
+      return true;
+    }
+    return false;
+  }
+
+  // 型ごとに足してから合わせる（static_shapes::TotalSize と同じ順）
+  double TotalSize() const {
+    double circleTotal = 0.0, rectangleTotal = 0.0;
+    for (const Circle *c : circles)
+      circleTotal += c->Circle::Size();
+    for (const Rectangle *r : rectangles)
+      rectangleTotal += r->Rectangle::Size();
+    return circleTotal + rectangleTotal;
+  }
+};
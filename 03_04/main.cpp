@@ -1,56 +1,43 @@
 #include <stdio.h>
+#include <stdlib.h>
 
-// ------------------------------
-// 抽象クラス
-// ------------------------------
-class IShape {
-public:
-  // 面積を返す
-  virtual double Size() const = 0;
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
 
-  // 図形を表示する
-  virtual void Draw() const = 0;
+#include "../03_03/DispatchBench.h"
+#include "ShapeStore.h"
+#include "Shapes.h"
+#include "SpatialIndex.h"
+#include "StaticShapes.h"
 
-  virtual ~IShape() {}
-};
-
-// ------------------------------
-// Circle（円）
-// ------------------------------
-class Circle : public IShape {
-public:
-  explicit Circle(double r) : m_radius(r) {}
+static void RunBenchmarks(size_t count);
+static void RunDispatchBenchmarks();
+static void RunSpatialBenchmarks(size_t count);
 
-  double Size() const override {
-    const double PI = 3.14159265358979323846;
-    return PI * m_radius * m_radius;
+int main(int argc, char *argv[]) {
+  if (argc >= 2 && std::string(argv[1]) == "--bench") {
+    const size_t count =
+        argc >= 3 ? static_cast<size_t>(strtoull(argv[2], nullptr, 10)) : 0;
+    RunBenchmarks(count > 0 ? count : 10000000);
+    return 0;
   }
-
-  void Draw() const override { printf("Circle (radius=%.2f)\n", m_radius); }
-
-private:
-  double m_radius;
-};
-
-// ------------------------------
-// Rectangle（長方形）
-// ------------------------------
-class Rectangle : public IShape {
-public:
-  Rectangle(double w, double h) : m_width(w), m_height(h) {}
-
-  double Size() const override { return m_width * m_height; }
-
-  void Draw() const override {
-    printf("Rectangle (width=%.2f, height=%.2f)\n", m_width, m_height);
+  if (argc >= 2 && std::string(argv[1]) == "--dispatch") {
+    RunDispatchBenchmarks();
+    return 0;
+  }
+  if (argc >= 2 && std::string(argv[1]) == "--spatial") {
+    const size_t count =
+        argc >= 3 ? static_cast<size_t>(strtoull(argv[2], nullptr, 10)) : 0;
+    RunSpatialBenchmarks(count > 0 ? count : 1000000);
+    return 0;
   }
 
-private:
-  double m_width;
-  double m_height;
-};
-
-int main(void) {
   // インスタンス生成
   Circle c(3.0);
   Rectangle r(4.0, 2.5);
@@ -66,3 +53,349 @@ int main(void) {
 
   return 0;
 }
+
+// ==============================
+//  ベンチマーク
+//   使い方: 03_04.exe --bench [図形の数（既定 1000 万）]
+//   円と長方形を半々に混ぜ、面積の合計と要素ごとの面積を
+//   IShape * の配列（new した順をシャッフル）と ShapeStore で比べる
+// ==============================
+using BenchClock = std::chrono::steady_clock;
+
+static volatile double g_benchSink;
+
+static double ElapsedMs(BenchClock::time_point t0) {
+  return std::chrono::duration<double, std::milli>(BenchClock::now() - t0)
+      .count();
+}
+
+static void RunBenchmarks(size_t count) {
+  std::mt19937 rng(2025);
+  std::uniform_real_distribution<double> length(0.5, 10.0);
+  std::uniform_real_distribution<double> position(0.0, 1000.0);
+  std::vector<IShape *> shapes(count);
+  ShapeStore store;
+  store.Reserve(count / 2 + 1, count / 2 + 1);
+  // 確認用に、ForEach が返す順（円をすべて → 長方形をすべて）の外接矩形
+  std::vector<Aabb> circleBounds, rectangleBounds;
+  for (auto &p : shapes) {
+    const double r = length(rng);
+    const Point center{position(rng), position(rng)};
+    if (rng() & 1) {
+      const Circle c(r, center);
+      p = new Circle(c);
+      store.Add(c);
+      circleBounds.push_back(c.Bounds());
+    } else {
+      const Rectangle rect(r, length(rng), center);
+      p = new Rectangle(rect);
+      store.Add(rect);
+      rectangleBounds.push_back(rect.Bounds());
+    }
+  }
+  std::vector<Aabb> storeOrder = circleBounds;
+  storeOrder.insert(storeOrder.end(), rectangleBounds.begin(),
+                    rectangleBounds.end());
+  // 確保した順に並んでいると実際より有利なので、参照する順をばらばらにする
+  std::shuffle(shapes.begin(), shapes.end(), rng);
+
+  printf("===== %zu shapes (%zu circles, %zu rectangles) =====\n", count,
+         store.circleCount(), store.rectangleCount());
+  printf("%-26s %10s %10s\n", "", "ms", "ns/shape");
+  const auto report = [count](const char *name, double ms) {
+    printf("%-26s %10.2f %10.2f\n", name, ms, ms * 1e6 / count);
+  };
+
+  // 面積の合計
+  auto t0 = BenchClock::now();
+  double virtualTotal = 0.0;
+  for (const IShape *s : shapes)
+    virtualTotal += s->Size();
+  report("total: IShape* virtual", ElapsedMs(t0));
+
+  t0 = BenchClock::now();
+  double forEachTotal = 0.0;
+  store.ForEach([&forEachTotal](const IShape &s) { forEachTotal += s.Size(); });
+  report("total: store ForEach", ElapsedMs(t0));
+
+  t0 = BenchClock::now();
+  const double storeTotal = store.TotalArea();
+  report("total: store TotalArea", ElapsedMs(t0));
+
+  // 要素ごとの面積を配列へ
+  std::vector<double> sizes(count);
+  t0 = BenchClock::now();
+  for (size_t i = 0; i < count; ++i)
+    sizes[i] = shapes[i]->Size();
+  report("sizes: IShape* virtual", ElapsedMs(t0));
+  g_benchSink = sizes[count / 2];
+
+  t0 = BenchClock::now();
+  store.CircleSizes(sizes.data());
+  store.RectangleSizes(sizes.data() + store.circleCount());
+  report("sizes: store kernels", ElapsedMs(t0));
+
+  // 確認：合計は丸めの範囲で一致、要素ごとの面積と位置はビット単位で一致
+  size_t mismatched = 0, i = 0;
+  store.ForEach([&](const IShape &s) {
+    const Aabb b = s.Bounds();
+    const Aabb &expected = storeOrder[i];
+    mismatched += s.Size() != sizes[i++] || b.minX != expected.minX ||
+                  b.minY != expected.minY || b.maxX != expected.maxX ||
+                  b.maxY != expected.maxY;
+  });
+  const double relative =
+      std::max(std::fabs(storeTotal - virtualTotal),
+               std::fabs(forEachTotal - virtualTotal)) /
+      virtualTotal;
+  printf("\ntotal area %.6e (relative diff %.1e)%s\n", storeTotal, relative,
+         relative < 1e-9 && mismatched == 0 ? "" : "  [result mismatch]");
+
+  for (IShape *s : shapes)
+    delete s;
+}
+
+// ==============================
+//  呼び出し方のベンチマーク
+//   使い方: 03_04.exe --dispatch
+//   面積の合計を求める（1図形あたりの ns。表の枠は ../03_03/DispatchBench.h）
+//   virtual は IShape *、variant は AnyShape、crtp は Circle / Rectangle の
+//   配列を TotalSize で、batched は ShapeBatches
+//   new は並んだ順に行うので、参照先はほぼ連続している
+//   （メモリの散らばりではなく、呼び出し方の違いを見る）
+// ==============================
+
+// 図形の型の並び（true なら円）
+static std::vector<bool> MakeKinds(size_t count, dispatch_bench::Mixing mixing,
+                                   std::mt19937 &rng) {
+  std::vector<bool> kinds(count);
+  for (size_t i = 0; i < count; ++i)
+    kinds[i] = (rng() & 1) != 0;
+  return dispatch_bench::Arrange(std::move(kinds), mixing);
+}
+
+static bool RunDispatchRow(size_t count, dispatch_bench::Mixing mixing,
+                           size_t reps, dispatch_bench::Times &t) {
+  using dispatch_bench::NsPerItem;
+
+  std::mt19937 rng(2025);
+  const std::vector<bool> kinds = MakeKinds(count, mixing, rng);
+  std::uniform_real_distribution<double> length(0.5, 10.0);
+  std::vector<std::unique_ptr<IShape>> shapes;
+  std::vector<static_shapes::AnyShape> variants;
+  std::vector<static_shapes::Circle> circles;
+  std::vector<static_shapes::Rectangle> rectangles;
+  shapes.reserve(count);
+  variants.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    if (kinds[i]) {
+      const double r = length(rng);
+      shapes.emplace_back(new Circle(r));
+      variants.emplace_back(static_shapes::Circle(r));
+      circles.emplace_back(r);
+    } else {
+      const double w = length(rng);
+      const double h = length(rng);
+      shapes.emplace_back(new Rectangle(w, h));
+      variants.emplace_back(static_shapes::Rectangle(w, h));
+      rectangles.emplace_back(w, h);
+    }
+  }
+  ShapeBatches batches;
+  for (const auto &s : shapes)
+    batches.Add(s.get());
+
+  double virtualTotal = 0.0, variantTotal = 0.0;
+  double crtpTotal = 0.0, batchedTotal = 0.0;
+  t.virtualNs = NsPerItem(count, reps, [&shapes, &virtualTotal] {
+    double total = 0.0;
+    for (const auto &s : shapes)
+      total += s->Size();
+    g_benchSink = virtualTotal = total;
+  });
+  t.variantNs = NsPerItem(count, reps, [&variants, &variantTotal] {
+    double total = 0.0;
+    for (const auto &s : variants)
+      total += static_shapes::Size(s);
+    g_benchSink = variantTotal = total;
+  });
+  t.crtpNs = NsPerItem(count, reps, [&circles, &rectangles, &crtpTotal] {
+    g_benchSink = crtpTotal = static_shapes::TotalSize(circles) +
+                              static_shapes::TotalSize(rectangles);
+  });
+  t.batchedNs = NsPerItem(count, reps, [&batches, &batchedTotal] {
+    g_benchSink = batchedTotal = batches.TotalSize();
+  });
+
+  // 足す順（とコンパイラが FMA にまとめるか）の分だけ丸めが違ってよい
+  const double tolerance = 1e-9 * virtualTotal;
+  return std::fabs(variantTotal - virtualTotal) <= tolerance &&
+         std::fabs(crtpTotal - virtualTotal) <= tolerance &&
+         std::fabs(batchedTotal - virtualTotal) <= tolerance;
+}
+
+static void RunDispatchBenchmarks() {
+  dispatch_bench::Run("total area, ns/shape", "shapes", RunDispatchRow);
+}
+
+// ==============================
+//  空間索引のベンチマーク
+//   使い方: 03_04.exe --spatial [図形の数（既定 100 万）]
+//   20000 x 20000 の範囲にばらまいた円と長方形で、ShapeBvh と ShapeGrid の
+//   作る時間と問い合わせ1回あたりの時間を、全図形をなめる場合（linear）と比べる
+//   linear は遅いので先頭の数回だけ計り、その結果で索引の答えも確かめる
+// ==============================
+struct SpatialHits {
+  size_t count;
+  double size;
+};
+
+static bool SameHits(const SpatialHits &a, const SpatialHits &b) {
+  return a.count == b.count &&
+         std::fabs(a.size - b.size) <= 1e-9 * std::max(a.size, b.size);
+}
+
+// f(i) を queries 回呼び、1回あたりの µs を返す
+template <class F> static double UsPerQuery(size_t queries, F f) {
+  const auto t0 = BenchClock::now();
+  for (size_t i = 0; i < queries; ++i)
+    f(i);
+  return ElapsedMs(t0) * 1e3 / queries;
+}
+
+static void RunSpatialBenchmarks(size_t count) {
+  const double kWorld = 20000.0;
+  const size_t kLinearQueries = 20;
+
+  std::mt19937 rng(2025);
+  std::uniform_real_distribution<double> position(0.0, kWorld);
+  std::uniform_real_distribution<double> length(0.5, 10.0);
+  std::vector<std::unique_ptr<IShape>> owned;
+  std::vector<const IShape *> shapes;
+  owned.reserve(count);
+  shapes.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    const Point center{position(rng), position(rng)};
+    if (rng() & 1) {
+      owned.emplace_back(new Circle(length(rng), center));
+    } else {
+      const double w = length(rng);
+      const double h = length(rng);
+      owned.emplace_back(new Rectangle(w, h, center));
+    }
+    shapes.push_back(owned.back().get());
+  }
+
+  printf("===== %zu shapes in %.0f x %.0f =====\n", count, kWorld, kWorld);
+  auto t0 = BenchClock::now();
+  const ShapeBvh bvh(shapes);
+  const double bvhMs = ElapsedMs(t0);
+  t0 = BenchClock::now();
+  const ShapeGrid grid(shapes);
+  const double gridMs = ElapsedMs(t0);
+  printf("build: ShapeBvh %.1f ms (%zu nodes), ShapeGrid %.1f ms "
+         "(%zu cells of %.2f)\n\n",
+         bvhMs, bvh.nodeCount(), gridMs, grid.cellCount(), grid.cellSize());
+
+  printf("%-18s %8s %10s %11s %9s %9s\n", "query", "count", "hits/query",
+         "linear us", "bvh us", "grid us");
+  // 問い合わせの種類ごとに、linear / bvh / grid の答えを求めて比べる
+  const auto run = [&](const char *name, size_t queries, auto linear,
+                       auto indexed) {
+    std::vector<SpatialHits> bvhHits(queries), gridHits(queries);
+    const double bvhUs = UsPerQuery(
+        queries, [&](size_t i) { bvhHits[i] = indexed(bvh, i); });
+    const double gridUs = UsPerQuery(
+        queries, [&](size_t i) { gridHits[i] = indexed(grid, i); });
+    const size_t linearQueries = std::min(queries, kLinearQueries);
+    std::vector<SpatialHits> linearHits(linearQueries);
+    const double linearUs = UsPerQuery(
+        linearQueries, [&](size_t i) { linearHits[i] = linear(i); });
+
+    bool ok = true;
+    double hits = 0.0;
+    for (size_t i = 0; i < queries; ++i) {
+      ok = ok && SameHits(bvhHits[i], gridHits[i]) &&
+           (i >= linearQueries || SameHits(bvhHits[i], linearHits[i]));
+      hits += bvhHits[i].count;
+    }
+    // 数を返さない問い合わせ（面積の合計）は "-"
+    char hitsText[32] = "-";
+    if (hits > 0.0)
+      snprintf(hitsText, sizeof(hitsText), "%.1f", hits / queries);
+    printf("%-18s %8zu %10s %11.1f %9.2f %9.2f%s\n", name, queries, hitsText,
+           linearUs, bvhUs, gridUs, ok ? "" : "  [result mismatch]");
+  };
+
+  // 問い合わせの位置（種類ごとに同じ並びを使う）
+  const auto regions = [&rng, &position](size_t n, double side) {
+    std::vector<Aabb> out(n);
+    for (auto &r : out) {
+      const double x = position(rng);
+      const double y = position(rng);
+      r = Aabb{x, y, x + side, y + side};
+    }
+    return out;
+  };
+
+  const std::vector<Aabb> small = regions(10000, 200.0);
+  run(
+      "rect 200x200", small.size(),
+      [&](size_t i) {
+        SpatialHits h{0, 0.0};
+        for (const IShape *s : shapes) {
+          if (s->Bounds().Overlaps(small[i])) {
+            ++h.count;
+            h.size += s->Size();
+          }
+        }
+        return h;
+      },
+      [&](const auto &index, size_t i) {
+        SpatialHits h{0, 0.0};
+        index.Query(small[i], [&h](const IShape &s) {
+          ++h.count;
+          h.size += s.Size();
+        });
+        return h;
+      });
+
+  std::vector<Point> points(100000);
+  for (auto &p : points)
+    p = Point{position(rng), position(rng)};
+  run(
+      "point", points.size(),
+      [&](size_t i) {
+        SpatialHits h{0, 0.0};
+        for (const IShape *s : shapes) {
+          if (s->Contains(points[i])) {
+            ++h.count;
+            h.size += s->Size();
+          }
+        }
+        return h;
+      },
+      [&](const auto &index, size_t i) {
+        SpatialHits h{0, 0.0};
+        index.QueryPoint(points[i], [&h](const IShape &s) {
+          ++h.count;
+          h.size += s.Size();
+        });
+        return h;
+      });
+
+  const std::vector<Aabb> large = regions(1000, 2000.0);
+  run(
+      "area in 2000x2000", large.size(),
+      [&](size_t i) {
+        SpatialHits h{0, 0.0};
+        for (const IShape *s : shapes) {
+          if (large[i].Contains(s->Bounds()))
+            h.size += s->Size();
+        }
+        return h;
+      },
+      [&](const auto &index, size_t i) {
+        return SpatialHits{0, index.AreaInside(large[i])};
+      });
+}
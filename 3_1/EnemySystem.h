@@ -0,0 +1,170 @@
+// EnemySystem.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ==============================
+//  たくさんの敵をまとめて動かす（データ指向版）
+//   接近 → 射撃 → 離脱 の決まりは Enemy と同じで、1体ずつの関数ポインタ
+//   呼び出しの代わりに、状態ごとのバケツ（SoA：項目ごとの配列）に分けて
+//   バケツ単位で同じ処理を回す。
+//   - 状態の分岐が無いので、各バケツの更新は単純なループ（ベクトル化できる）
+//   - 遷移する敵だけを次のバケツへ移す（末尾と入れ替えて詰める）
+//  1フレームでは Retreat → Shoot → Approach の順に更新し、そのフレームで
+//  遷移した敵が次の状態の処理まで進んでしまわないようにする
+//  （1体ずつ Update() を1回呼ぶのと同じ結果になる）
+// ==============================
+
+enum class EnemyState { Approach, Shoot, Retreat };
+const int kEnemyStateCount = 3;
+
+// 動きの決まり
+struct EnemyRules {
+  float shootRange = 20.0f;    // この距離まで近づいたら射撃に移る
+  int shootFrames = 30;        // 射撃を続けるフレーム数（1フレーム1発）
+  float despawnRange = 200.0f; // 離脱してこの距離を超えたら終了
+};
+
+// 出現位置と、接近するときの1フレームの移動量
+struct EnemySpawn {
+  float x, y;
+  float vx, vy;
+};
+
+class EnemySystem {
+public:
+  explicit EnemySystem(const EnemyRules &rules = EnemyRules())
+      : m_rules(rules) {}
+
+  void Reserve(size_t count) {
+    for (auto &bucket : m_buckets)
+      bucket.Reserve(count);
+  }
+
+  void Spawn(const EnemySpawn &s) {
+    m_buckets[Index(EnemyState::Approach)].Push(s.x, s.y, s.vx, s.vy, 0);
+  }
+
+  // 1フレーム進める
+  void Update() {
+    UpdateRetreat();
+    UpdateShoot();
+    UpdateApproach();
+  }
+
+  size_t count(EnemyState state) const {
+    return m_buckets[Index(state)].size();
+  }
+  size_t active() const {
+    size_t n = 0;
+    for (const auto &bucket : m_buckets)
+      n += bucket.size();
+    return n;
+  }
+  std::uint64_t finished() const { return m_finished; }
+  std::uint64_t shots() const { return m_shots; }
+
+private:
+  struct Bucket {
+    std::vector<float> x, y, vx, vy;
+    std::vector<int> timer;
+
+    size_t size() const { return x.size(); }
+    void Reserve(size_t n) {
+      x.reserve(n);
+      y.reserve(n);
+      vx.reserve(n);
+      vy.reserve(n);
+      timer.reserve(n);
+    }
+    void Push(float px, float py, float pvx, float pvy, int t) {
+      x.push_back(px);
+      y.push_back(py);
+      vx.push_back(pvx);
+      vy.push_back(pvy);
+      timer.push_back(t);
+    }
+    // i 番目を to へ移し（to が nullptr なら捨て）、末尾で埋める
+    void MoveOut(size_t i, Bucket *to, int t) {
+      if (to)
+        to->Push(x[i], y[i], vx[i], vy[i], t);
+      const size_t last = size() - 1;
+      x[i] = x[last];
+      y[i] = y[last];
+      vx[i] = vx[last];
+      vy[i] = vy[last];
+      timer[i] = timer[last];
+      x.pop_back();
+      y.pop_back();
+      vx.pop_back();
+      vy.pop_back();
+      timer.pop_back();
+    }
+  };
+
+  static int Index(EnemyState state) { return static_cast<int>(state); }
+
+  // 遷移する添字を集めてから大きい順に移す（詰めても未処理の添字が動かない）
+  void MoveLeaving(Bucket &from, Bucket *to, int timer) {
+    for (size_t k = m_leaving.size(); k-- > 0;)
+      from.MoveOut(m_leaving[k], to, timer);
+    m_leaving.clear();
+  }
+
+  void UpdateApproach() {
+    Bucket &b = m_buckets[Index(EnemyState::Approach)];
+    const size_t n = b.size();
+    float *x = b.x.data(), *y = b.y.data();
+    const float *vx = b.vx.data(), *vy = b.vy.data();
+    for (size_t i = 0; i < n; ++i) {
+      x[i] += vx[i];
+      y[i] += vy[i];
+    }
+    const float r2 = m_rules.shootRange * m_rules.shootRange;
+    for (size_t i = 0; i < n; ++i) {
+      if (x[i] * x[i] + y[i] * y[i] < r2)
+        m_leaving.push_back(i);
+    }
+    MoveLeaving(b, &m_buckets[Index(EnemyState::Shoot)], m_rules.shootFrames);
+  }
+
+  void UpdateShoot() {
+    Bucket &b = m_buckets[Index(EnemyState::Shoot)];
+    const size_t n = b.size();
+    int *timer = b.timer.data();
+    m_shots += n;
+    for (size_t i = 0; i < n; ++i)
+      --timer[i];
+    for (size_t i = 0; i < n; ++i) {
+      if (timer[i] == 0)
+        m_leaving.push_back(i);
+    }
+    MoveLeaving(b, &m_buckets[Index(EnemyState::Retreat)], 0);
+  }
+
+  void UpdateRetreat() {
+    Bucket &b = m_buckets[Index(EnemyState::Retreat)];
+    const size_t n = b.size();
+    float *x = b.x.data(), *y = b.y.data();
+    const float *vx = b.vx.data(), *vy = b.vy.data();
+    for (size_t i = 0; i < n; ++i) {
+      x[i] -= vx[i];
+      y[i] -= vy[i];
+    }
+    const float r2 = m_rules.despawnRange * m_rules.despawnRange;
+    for (size_t i = 0; i < n; ++i) {
+      if (x[i] * x[i] + y[i] * y[i] > r2)
+        m_leaving.push_back(i);
+    }
+    m_finished += m_leaving.size();
+    MoveLeaving(b, nullptr, 0);
+  }
+
+  EnemyRules m_rules;
+  Bucket m_buckets[kEnemyStateCount];
+  std::vector<size_t> m_leaving; // 作業用（遷移する添字）
+  std::uint64_t m_finished = 0;
+  std::uint64_t m_shots = 0;
+};
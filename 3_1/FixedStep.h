@@ -0,0 +1,71 @@
+// FixedStep.h
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+// ==============================
+//  固定刻みの時計
+//   実時間の経過を溜めておき、刻み step の何回分進めるかを返す
+//   （端数は次へ持ち越す）。止まっていた後に一気に追いつこうとして
+//   処理が間に合わなくなる（遅れが遅れを呼ぶ）のを防ぐため、
+//   1回に進めるのは maxSteps まで。溢れた分は捨てる
+// ==============================
+class FixedStepClock {
+public:
+  explicit FixedStepClock(double step, int maxSteps = 8)
+      : m_step(step), m_maxSteps(maxSteps) {}
+
+  double step() const { return m_step; }
+
+  int Advance(double elapsed) {
+    m_accumulated += elapsed;
+    int steps = static_cast<int>(m_accumulated / m_step);
+    if (steps > m_maxSteps) {
+      steps = m_maxSteps;
+      m_accumulated = 0.0;
+    } else {
+      m_accumulated -= steps * m_step;
+    }
+    return steps;
+  }
+
+private:
+  double m_step;
+  int m_maxSteps;
+  double m_accumulated = 0.0;
+};
+
+// ==============================
+//  固定刻みで回す
+//   RunRealtime … 実時間に合わせて step(dt) を呼ぶ（刻みの間は眠る）
+//   RunHeadless … 待たずにできるだけ速く step(dt) を呼ぶ
+//  どちらも done() が true になるまで。戻り値は step を呼んだ回数
+// ==============================
+template <class Step, class Done>
+std::uint64_t RunRealtime(double dt, Step &&step, Done &&done) {
+  using Clock = std::chrono::steady_clock;
+  FixedStepClock clock(dt);
+  std::uint64_t steps = 0;
+  Clock::time_point prev = Clock::now();
+  while (!done()) {
+    const Clock::time_point now = Clock::now();
+    const int n =
+        clock.Advance(std::chrono::duration<double>(now - prev).count());
+    prev = now;
+    for (int i = 0; i < n && !done(); ++i, ++steps)
+      step(dt);
+    if (n == 0)
+      std::this_thread::sleep_for(std::chrono::duration<double>(dt / 4));
+  }
+  return steps;
+}
+
+template <class Step, class Done>
+std::uint64_t RunHeadless(double dt, Step &&step, Done &&done) {
+  std::uint64_t steps = 0;
+  for (; !done(); ++steps)
+    step(dt);
+  return steps;
+}
@@ -0,0 +1,128 @@
+// StateMachine.h
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// ==============================
+//  遷移表をコンパイル時に持つ状態機械
+//   状態はそれぞれ構造体で、次に行ける状態の一覧を型で書いておく
+//     struct Approach {
+//       using Transitions = StateList<Shoot>;
+//       template <class Go> void Update(Enemy &e, double dt, Go &go) {
+//         if (...) Goto<Shoot>(go);
+//       }
+//     };
+//     StateMachine<Approach, Shoot, Retreat> machine; // 先頭が最初の状態
+//     machine.Update(enemy, dt);
+//   - 表に無い遷移（Goto<Retreat>(go) を Approach で呼ぶなど）は
+//     static_assert でコンパイルエラーになる
+//   - 呼び出しは状態の添字の比較の並びに展開され、コンパイラが
+//     switch（ジャンプ表）にする。関数ポインタも仮想関数も通らないので
+//     各状態の Update はインライン化できる
+// ==============================
+template <class... States> struct StateList {};
+
+namespace state_machine_detail {
+
+template <class T, class List> struct Contains;
+template <class T, class... Ts>
+struct Contains<T, StateList<Ts...>>
+    : std::bool_constant<(std::is_same_v<T, Ts> || ...)> {};
+
+// Ts の中の T の位置（無ければ sizeof...(Ts)）
+template <class T, class... Ts> constexpr size_t IndexOf() {
+  constexpr bool match[] = {std::is_same_v<T, Ts>...};
+  for (size_t i = 0; i < sizeof...(Ts); ++i) {
+    if (match[i])
+      return i;
+  }
+  return sizeof...(Ts);
+}
+
+} // namespace state_machine_detail
+
+// 状態の Update の中で、次の状態を決める
+template <class To, class Go> void Goto(Go &go) { go.template Set<To>(); }
+
+template <class... States> class StateMachine {
+public:
+  static constexpr size_t kStateCount = sizeof...(States);
+  static_assert(kStateCount > 0 && kStateCount < 256, "状態の数が不正です");
+
+  template <class S> static constexpr size_t IndexOf() {
+    return state_machine_detail::IndexOf<S, States...>();
+  }
+
+  template <class From, class To> static constexpr bool CanTransition() {
+    return state_machine_detail::Contains<
+        To, typename From::Transitions>::value;
+  }
+
+  // 遷移表の1行（From から各状態へ）
+  template <class From>
+  static constexpr std::array<bool, kStateCount> TransitionRow() {
+    return {{CanTransition<From, States>()...}};
+  }
+
+  // 遷移表 kTable[from][to]（添字で問い合わせたいとき用）
+  static constexpr std::array<std::array<bool, kStateCount>, kStateCount>
+      kTable = {{TransitionRow<States>()...}};
+
+  size_t index() const { return m_index; }
+  template <class S> bool Is() const { return m_index == IndexOf<S>(); }
+  template <class S> S &state() { return std::get<IndexOf<S>()>(m_states); }
+
+  // 今の状態の Update(args..., go) を呼び、Goto されていれば移る
+  template <class... Args> void Update(Args &&...args) {
+    Dispatch(std::index_sequence_for<States...>{}, args...);
+  }
+
+  // Update の最後の引数。From から行ける状態への Goto だけを受け付ける
+  template <class From> class Transition {
+  public:
+    template <class To> void Set() {
+      static_assert(IndexOf<To>() < kStateCount,
+                    "この状態機械の状態ではありません");
+      static_assert(CanTransition<From, To>(),
+                    "遷移表に無い遷移です（From::Transitions を確認）");
+      m_next = static_cast<std::uint8_t>(IndexOf<To>());
+    }
+
+  private:
+    friend StateMachine;
+    std::uint8_t m_next = kNone;
+  };
+
+private:
+  static constexpr std::uint8_t kNone = 0xFF;
+
+  // 一覧に書いた遷移先がすべてこの状態機械の状態か
+  template <class S, class List> struct KnownTargets;
+  template <class S, class... Ts> struct KnownTargets<S, StateList<Ts...>> {
+    static constexpr bool value = ((IndexOf<Ts>() < kStateCount) && ...);
+  };
+  static_assert((KnownTargets<States, typename States::Transitions>::value &&
+                 ...),
+                "Transitions に状態機械に無い状態があります");
+
+  template <size_t... I, class... Args>
+  void Dispatch(std::index_sequence<I...>, Args &...args) {
+    (void)((m_index == I && (Call<I>(args...), true)) || ...);
+  }
+
+  template <size_t I, class... Args> void Call(Args &...args) {
+    using S = std::tuple_element_t<I, std::tuple<States...>>;
+    Transition<S> go;
+    std::get<I>(m_states).Update(args..., go);
+    if (go.m_next != kNone)
+      m_index = go.m_next;
+  }
+
+  std::tuple<States...> m_states;
+  std::uint8_t m_index = 0;
+};
@@ -1,20 +1,43 @@
 #include <stdio.h>
-#include <windows.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "EnemySystem.h"
+#include "FixedStep.h"
+#include "StateMachine.h"
+
+// 敵の各状態の長さ（秒）
+struct EnemyDurations {
+  double approach = 1.0;
+  double shoot = 1.0;
+  double retreat = 1.0;
+};
 
 class Enemy {
 public:
-  Enemy() : m_state(&Enemy::Approach), m_finished(false) {}
+  // log が nullptr なら何も表示しない（たくさん動かすとき用）
+  explicit Enemy(FILE *log = stdout,
+                 const EnemyDurations &durations = EnemyDurations())
+      : m_state(&Enemy::Approach), m_finished(false), m_log(log),
+        m_durations(durations) {}
 
-  void Update() {
+  // dt 秒進める（待たずにすぐ戻る）
+  void Update(double dt) {
     // 現在の状態（メンバ関数ポインタ）を実行
-    (this->*m_state)();
+    (this->*m_state)(dt);
   }
 
   bool IsFinished() const { return m_finished; }
 
 private:
   // メンバ関数ポインタ型
-  using StateFunc = void (Enemy::*)();
+  using StateFunc = void (Enemy::*)(double);
 
   // 現在の状態
   StateFunc m_state;
@@ -22,40 +45,552 @@ private:
   // 離脱が終わったら終了
   bool m_finished;
 
+  FILE *m_log;
+  EnemyDurations m_durations;
+  double m_stateTime = 0.0; // 今の状態になってからの時間
+  bool m_entered = false;   // 今の状態の最初の Update を済ませたか
+
 private:
-  void Approach() {
-    printf("【接近】敵が接近しています...\n");
-    Sleep(1000);
+  // 状態に入った最初の1回だけ表示する
+  void Enter(const char *message) {
+    if (m_entered)
+      return;
+    m_entered = true;
+    if (m_log)
+      fprintf(m_log, "%s\n", message);
+  }
+
+  // 時間を進め、duration を過ぎたら true（過ぎた分は次の状態へ持ち越す）
+  bool Elapse(double dt, double duration) {
+    // 刻みを足し合わせた誤差で1刻み遅れないよう、わずかに甘く見る
+    const double kEpsilon = 1e-9;
+    m_stateTime += dt;
+    if (m_stateTime + kEpsilon < duration)
+      return false;
+    m_stateTime -= duration;
+    if (m_stateTime < 0.0)
+      m_stateTime = 0.0;
+    m_entered = false;
+    return true;
+  }
+
+  void Approach(double dt) {
+    Enter("【接近】敵が接近しています...");
 
     // 次の状態へ
-    m_state = &Enemy::Shoot;
+    if (Elapse(dt, m_durations.approach))
+      m_state = &Enemy::Shoot;
   }
 
-  void Shoot() {
-    printf("【射撃】敵が射撃しました！\n");
-    Sleep(1000);
+  void Shoot(double dt) {
+    Enter("【射撃】敵が射撃しました！");
 
     // 次の状態へ
-    m_state = &Enemy::Retreat;
+    if (Elapse(dt, m_durations.shoot))
+      m_state = &Enemy::Retreat;
   }
 
-  void Retreat() {
-    printf("【離脱】敵が離脱しました。\n");
-    Sleep(1000);
+  void Retreat(double dt) {
+    Enter("【離脱】敵が離脱しました。");
 
     // 終了
-    m_finished = true;
+    if (Elapse(dt, m_durations.retreat))
+      m_finished = true;
   }
 };
 
-int main(void) {
-  Enemy enemy;
+// 1フレームの長さ（秒）
+const double kFrameSeconds = 1.0 / 60.0;
 
-  // 状態遷移（接近 → 射撃 → 離脱）を順に実行
-  while (!enemy.IsFinished()) {
-    enemy.Update();
+static void RunBenchmarks();
+static int RunSimulation(int argc, char *argv[]);
+
+int main(int argc, char *argv[]) {
+  if (argc >= 2 && std::string(argv[1]) == "--bench") {
+    RunBenchmarks();
+    return 0;
   }
+  if (argc >= 2 && std::string(argv[1]) == "--simulate")
+    return RunSimulation(argc, argv);
+
+  Enemy enemy;
+
+  // 状態遷移（接近 → 射撃 → 離脱）を実時間の固定刻みで順に実行
+  RunRealtime(
+      kFrameSeconds, [&enemy](double dt) { enemy.Update(dt); },
+      [&enemy] { return enemy.IsFinished(); });
 
   printf("処理を終了します。\n");
   return 0;
 }
+
+// ==============================
+//  シミュレーション（表示も待ちもせず、できるだけ速く回す）
+//   使い方: 3_1.exe --simulate [敵の数] [--dt 秒]
+//   状態の長さを 0.5～2 秒でばらつかせた敵を全員終わるまで固定刻みで進め、
+//   進んだ時間と実際にかかった時間を比べる
+// ==============================
+static int RunSimulation(int argc, char *argv[]) {
+  size_t count = 10000;
+  double dt = kFrameSeconds;
+  for (int i = 2; i < argc; ++i) {
+    const std::string arg = argv[i];
+    char *end = nullptr;
+    if (arg == "--dt" && i + 1 < argc) {
+      dt = strtod(argv[++i], &end);
+      if (*end != '\0' || !(dt > 0.0)) {
+        fprintf(stderr, "[Error] --dt には正の秒数を指定してください\n");
+        return 1;
+      }
+    } else {
+      const unsigned long long n = strtoull(argv[i], &end, 10);
+      if (*end != '\0' || n == 0) {
+        fprintf(stderr, "[Error] 引数が不正です: %s\n", argv[i]);
+        return 1;
+      }
+      count = static_cast<size_t>(n);
+    }
+  }
+
+  std::mt19937 rng(2025);
+  std::uniform_real_distribution<double> seconds(0.5, 2.0);
+  std::vector<Enemy> enemies;
+  enemies.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    EnemyDurations d;
+    d.approach = seconds(rng);
+    d.shoot = seconds(rng);
+    d.retreat = seconds(rng);
+    enemies.emplace_back(nullptr, d);
+  }
+
+  size_t alive = enemies.size();
+  std::uint64_t updates = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  const std::uint64_t steps = RunHeadless(
+      dt,
+      [&](double step) {
+        updates += alive;
+        alive = 0;
+        for (auto &e : enemies) {
+          if (e.IsFinished())
+            continue;
+          e.Update(step);
+          alive += !e.IsFinished();
+        }
+      },
+      [&alive] { return alive == 0; });
+  const double wallSec =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - t0)
+          .count();
+
+  const double simSec = steps * dt;
+  printf("enemies   : %zu (dt %.6f s)\n", count, dt);
+  printf("steps     : %llu (%.3f s simulated)\n",
+         static_cast<unsigned long long>(steps), simSec);
+  printf("wall      : %.3f ms (%.0fx real time, %.1f M updates / s)\n",
+         wallSec * 1e3, simSec / wallSec, updates / wallSec / 1e6);
+  return 0;
+}
+
+// ==============================
+//  ベンチマーク
+//   使い方: 3_1.exe --bench
+//   1k / 100k / 1M 体が全員離脱し終わるまでを、1体ずつメンバ関数ポインタで
+//   呼ぶ版と EnemySystem（状態ごとのバケツ）で比べる
+// ==============================
+using BenchClock = std::chrono::steady_clock;
+
+// Enemy と同じ作りで、EnemySystem と同じ決まりで動く版（表示・待ちなし）
+class PointerEnemy {
+public:
+  PointerEnemy(const EnemySpawn &s, const EnemyRules &rules)
+      : m_state(&PointerEnemy::Approach), m_rules(&rules), m_x(s.x),
+        m_y(s.y), m_vx(s.vx), m_vy(s.vy) {}
+
+  void Update() { (this->*m_state)(); }
+
+  bool IsFinished() const { return m_state == nullptr; }
+  std::uint64_t shots() const { return m_shots; }
+
+private:
+  using StateFunc = void (PointerEnemy::*)();
+
+  void Approach() {
+    m_x += m_vx;
+    m_y += m_vy;
+    if (m_x * m_x + m_y * m_y < m_rules->shootRange * m_rules->shootRange) {
+      m_timer = m_rules->shootFrames;
+      m_state = &PointerEnemy::Shoot;
+    }
+  }
+  void Shoot() {
+    ++m_shots;
+    if (--m_timer == 0)
+      m_state = &PointerEnemy::Retreat;
+  }
+  void Retreat() {
+    m_x -= m_vx;
+    m_y -= m_vy;
+    if (m_x * m_x + m_y * m_y >
+        m_rules->despawnRange * m_rules->despawnRange)
+      m_state = nullptr;
+  }
+
+  StateFunc m_state;
+  const EnemyRules *m_rules;
+  float m_x, m_y, m_vx, m_vy;
+  int m_timer = 0;
+  std::uint64_t m_shots = 0;
+};
+
+// 半径 50～150 の円周上から、1フレーム 1～3 の速さで中心へ向かう
+static std::vector<EnemySpawn> MakeSpawns(size_t count) {
+  std::mt19937 rng(2025);
+  std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+  std::uniform_real_distribution<float> radius(50.0f, 150.0f);
+  std::uniform_real_distribution<float> speed(1.0f, 3.0f);
+  std::vector<EnemySpawn> spawns(count);
+  for (auto &s : spawns) {
+    const float a = angle(rng), r = radius(rng), v = speed(rng);
+    const float cx = std::cos(a), cy = std::sin(a);
+    s = {cx * r, cy * r, -cx * v, -cy * v};
+  }
+  return spawns;
+}
+
+struct EnemyRun {
+  double ms = 0.0;
+  int frames = 0;
+  std::uint64_t updates = 0; // 敵 × フレーム
+  std::uint64_t shots = 0;
+};
+
+static EnemyRun RunPointerEnemies(const std::vector<EnemySpawn> &spawns,
+                                  const EnemyRules &rules) {
+  std::vector<PointerEnemy> enemies;
+  enemies.reserve(spawns.size());
+  for (const auto &s : spawns)
+    enemies.emplace_back(s, rules);
+
+  EnemyRun run;
+  const auto t0 = BenchClock::now();
+  for (size_t alive = enemies.size(); alive > 0; ++run.frames) {
+    run.updates += alive;
+    alive = 0;
+    for (auto &e : enemies) {
+      if (e.IsFinished())
+        continue;
+      e.Update();
+      alive += !e.IsFinished();
+    }
+  }
+  run.ms = std::chrono::duration<double, std::milli>(BenchClock::now() - t0)
+               .count();
+  for (const auto &e : enemies)
+    run.shots += e.shots();
+  return run;
+}
+
+static EnemyRun RunEnemySystem(const std::vector<EnemySpawn> &spawns,
+                               const EnemyRules &rules) {
+  EnemySystem system(rules);
+  system.Reserve(spawns.size());
+  for (const auto &s : spawns)
+    system.Spawn(s);
+
+  EnemyRun run;
+  const auto t0 = BenchClock::now();
+  for (; system.active() > 0; ++run.frames) {
+    run.updates += system.active();
+    system.Update();
+  }
+  run.ms = std::chrono::duration<double, std::milli>(BenchClock::now() - t0)
+               .count();
+  run.shots = system.shots();
+  return run;
+}
+
+// ==============================
+//  状態の呼び分け方の比較
+//   接近 → 射撃 → 離脱 → 接近 … を各状態の長さ（敵ごとに 0.05～0.5 秒）で
+//   繰り返す敵を、4通りの作りで同じ回数だけ Update する
+//   - pointer … Enemy と同じメンバ関数ポインタ
+//   - virtual … 状態オブジェクト（仮想関数）へのポインタ
+//   - variant … std::variant の状態を std::visit で
+//   - table   … StateMachine（遷移表をコンパイル時に持つ）
+// ==============================
+struct PatrolData {
+  double approach, shoot, retreat; // 各状態の長さ
+  double time = 0.0;               // 今の状態になってからの時間
+  std::uint64_t shots = 0;
+  std::uint64_t laps = 0; // 離脱し終えた回数
+};
+
+// 状態の時間を進め、長さを過ぎたら true（過ぎた分は持ち越す）
+static inline bool PatrolElapse(PatrolData &d, double dt, double duration) {
+  d.time += dt;
+  if (d.time < duration)
+    return false;
+  d.time -= duration;
+  return true;
+}
+
+class PointerPatrol {
+public:
+  explicit PointerPatrol(const PatrolData &d)
+      : m_state(&PointerPatrol::Approach), m_data(d) {}
+  void Update(double dt) { (this->*m_state)(dt); }
+  const PatrolData &data() const { return m_data; }
+
+private:
+  using StateFunc = void (PointerPatrol::*)(double);
+  void Approach(double dt) {
+    if (PatrolElapse(m_data, dt, m_data.approach))
+      m_state = &PointerPatrol::Shoot;
+  }
+  void Shoot(double dt) {
+    ++m_data.shots;
+    if (PatrolElapse(m_data, dt, m_data.shoot))
+      m_state = &PointerPatrol::Retreat;
+  }
+  void Retreat(double dt) {
+    if (PatrolElapse(m_data, dt, m_data.retreat)) {
+      ++m_data.laps;
+      m_state = &PointerPatrol::Approach;
+    }
+  }
+
+  StateFunc m_state;
+  PatrolData m_data;
+};
+
+// 状態オブジェクト（中身を持たないので全員で1つずつを共有する）
+class PatrolState {
+public:
+  virtual ~PatrolState() = default;
+  // 次の状態を返す（そのままなら this）
+  virtual const PatrolState *Update(PatrolData &d, double dt) const = 0;
+};
+
+class VirtualApproach final : public PatrolState {
+public:
+  const PatrolState *Update(PatrolData &d, double dt) const override;
+};
+class VirtualShoot final : public PatrolState {
+public:
+  const PatrolState *Update(PatrolData &d, double dt) const override;
+};
+class VirtualRetreat final : public PatrolState {
+public:
+  const PatrolState *Update(PatrolData &d, double dt) const override;
+};
+
+static const VirtualApproach g_virtualApproach;
+static const VirtualShoot g_virtualShoot;
+static const VirtualRetreat g_virtualRetreat;
+
+const PatrolState *VirtualApproach::Update(PatrolData &d, double dt) const {
+  if (!PatrolElapse(d, dt, d.approach))
+    return this;
+  return &g_virtualShoot;
+}
+const PatrolState *VirtualShoot::Update(PatrolData &d, double dt) const {
+  ++d.shots;
+  if (!PatrolElapse(d, dt, d.shoot))
+    return this;
+  return &g_virtualRetreat;
+}
+const PatrolState *VirtualRetreat::Update(PatrolData &d, double dt) const {
+  if (!PatrolElapse(d, dt, d.retreat))
+    return this;
+  ++d.laps;
+  return &g_virtualApproach;
+}
+
+class VirtualPatrol {
+public:
+  explicit VirtualPatrol(const PatrolData &d)
+      : m_state(&g_virtualApproach), m_data(d) {}
+  void Update(double dt) { m_state = m_state->Update(m_data, dt); }
+  const PatrolData &data() const { return m_data; }
+
+private:
+  const PatrolState *m_state;
+  PatrolData m_data;
+};
+
+// std::variant 版（各状態の Update は次の状態を返す）
+struct VariantApproach;
+struct VariantShoot;
+struct VariantRetreat;
+using PatrolVariant =
+    std::variant<VariantApproach, VariantShoot, VariantRetreat>;
+
+struct VariantApproach {
+  PatrolVariant Update(PatrolData &d, double dt) const;
+};
+struct VariantShoot {
+  PatrolVariant Update(PatrolData &d, double dt) const;
+};
+struct VariantRetreat {
+  PatrolVariant Update(PatrolData &d, double dt) const;
+};
+
+inline PatrolVariant VariantApproach::Update(PatrolData &d,
+                                             double dt) const {
+  if (PatrolElapse(d, dt, d.approach))
+    return VariantShoot{};
+  return *this;
+}
+inline PatrolVariant VariantShoot::Update(PatrolData &d, double dt) const {
+  ++d.shots;
+  if (PatrolElapse(d, dt, d.shoot))
+    return VariantRetreat{};
+  return *this;
+}
+inline PatrolVariant VariantRetreat::Update(PatrolData &d, double dt) const {
+  if (!PatrolElapse(d, dt, d.retreat))
+    return *this;
+  ++d.laps;
+  return VariantApproach{};
+}
+
+class VariantPatrol {
+public:
+  explicit VariantPatrol(const PatrolData &d) : m_data(d) {}
+  void Update(double dt) {
+    m_state = std::visit(
+        [this, dt](const auto &state) { return state.Update(m_data, dt); },
+        m_state);
+  }
+  const PatrolData &data() const { return m_data; }
+
+private:
+  PatrolVariant m_state;
+  PatrolData m_data;
+};
+
+// StateMachine 版（Goto できるのは Transitions に書いた状態だけ）
+struct TableShoot;
+struct TableRetreat;
+
+struct TableApproach {
+  using Transitions = StateList<TableShoot>;
+  template <class Go> void Update(PatrolData &d, double dt, Go &go) {
+    if (PatrolElapse(d, dt, d.approach))
+      Goto<TableShoot>(go);
+  }
+};
+struct TableShoot {
+  using Transitions = StateList<TableRetreat>;
+  template <class Go> void Update(PatrolData &d, double dt, Go &go) {
+    ++d.shots;
+    if (PatrolElapse(d, dt, d.shoot))
+      Goto<TableRetreat>(go);
+  }
+};
+struct TableRetreat {
+  using Transitions = StateList<TableApproach>;
+  template <class Go> void Update(PatrolData &d, double dt, Go &go) {
+    if (PatrolElapse(d, dt, d.retreat)) {
+      ++d.laps;
+      Goto<TableApproach>(go);
+    }
+  }
+};
+
+using PatrolMachine = StateMachine<TableApproach, TableShoot, TableRetreat>;
+static_assert(PatrolMachine::kTable[0][1] && !PatrolMachine::kTable[0][2],
+              "接近から行けるのは射撃だけ");
+
+class TablePatrol {
+public:
+  explicit TablePatrol(const PatrolData &d) : m_data(d) {}
+  void Update(double dt) { m_machine.Update(m_data, dt); }
+  const PatrolData &data() const { return m_data; }
+
+private:
+  PatrolMachine m_machine;
+  PatrolData m_data;
+};
+
+// count 体を steps 回ずつ。戻り値は 1 Update あたりの ns
+template <class Patrol>
+static double BenchPatrol(const std::vector<PatrolData> &init, int steps,
+                          std::uint64_t &shots, std::uint64_t &laps) {
+  std::vector<Patrol> enemies;
+  enemies.reserve(init.size());
+  for (const auto &d : init)
+    enemies.emplace_back(d);
+
+  const auto t0 = BenchClock::now();
+  for (int s = 0; s < steps; ++s) {
+    for (auto &e : enemies)
+      e.Update(kFrameSeconds);
+  }
+  const double ns =
+      std::chrono::duration<double, std::nano>(BenchClock::now() - t0)
+          .count();
+
+  shots = laps = 0;
+  for (const auto &e : enemies) {
+    shots += e.data().shots;
+    laps += e.data().laps;
+  }
+  return ns / (static_cast<double>(init.size()) * steps);
+}
+
+// mixed が true なら敵ごとに状態の長さを変え（状態がばらばらで分岐予測が
+// 外れやすい）、false なら全員同じ長さ（全員が同じ状態で予測が当たる）
+static void RunDispatchBenchmarks(bool mixed) {
+  const size_t kEnemies = 10000;
+  const int kSteps = 1000;
+  std::mt19937 rng(2025);
+  std::uniform_real_distribution<double> seconds(0.05, 0.5);
+  std::vector<PatrolData> init(kEnemies);
+  for (auto &d : init) {
+    d.approach = mixed ? seconds(rng) : 0.25;
+    d.shoot = mixed ? seconds(rng) : 0.1;
+    d.retreat = mixed ? seconds(rng) : 0.4;
+  }
+
+  printf("\n===== state dispatch, %zu enemies x %d updates, %s =====\n",
+         kEnemies, kSteps, mixed ? "mixed states" : "lockstep");
+  printf("%-8s %10s %8s\n", "version", "ns/update", "speedup");
+  std::uint64_t refShots = 0, refLaps = 0, shots = 0, laps = 0;
+  const double pointer =
+      BenchPatrol<PointerPatrol>(init, kSteps, refShots, refLaps);
+  printf("%-8s %10.2f %8s\n", "pointer", pointer, "-");
+  const auto report = [&](const char *name, double ns) {
+    printf("%-8s %10.2f %7.2fx%s\n", name, ns, pointer / ns,
+           shots == refShots && laps == refLaps ? "" : "  [result mismatch]");
+  };
+  report("virtual", BenchPatrol<VirtualPatrol>(init, kSteps, shots, laps));
+  report("variant", BenchPatrol<VariantPatrol>(init, kSteps, shots, laps));
+  report("table", BenchPatrol<TablePatrol>(init, kSteps, shots, laps));
+}
+
+static void RunBenchmarks() {
+  const EnemyRules rules;
+  printf("===== enemy buckets (until every enemy retreats) =====\n");
+  printf("%-9s %-8s %7s %10s %10s %8s\n", "enemies", "version", "frames",
+         "ms", "ns/update", "speedup");
+  for (size_t count : {size_t{1000}, size_t{100000}, size_t{1000000}}) {
+    const std::vector<EnemySpawn> spawns = MakeSpawns(count);
+    const EnemyRun pointer = RunPointerEnemies(spawns, rules);
+    const EnemyRun system = RunEnemySystem(spawns, rules);
+    const bool same = pointer.frames == system.frames &&
+                      pointer.updates == system.updates &&
+                      pointer.shots == system.shots;
+    printf("%-9zu %-8s %7d %10.2f %10.2f %8s\n", count, "pointer",
+           pointer.frames, pointer.ms, pointer.ms * 1e6 / pointer.updates,
+           "-");
+    printf("%-9s %-8s %7d %10.2f %10.2f %7.2fx%s\n", "", "buckets",
+           system.frames, system.ms, system.ms * 1e6 / system.updates,
+           pointer.ms / system.ms, same ? "" : "  [result mismatch]");
+  }
+
+  RunDispatchBenchmarks(true);
+  RunDispatchBenchmarks(false);
+}